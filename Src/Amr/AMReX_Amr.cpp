@@ -79,6 +79,7 @@ namespace
     int  probinit_natonce;
 #endif
     bool plot_files_output;
+    bool plot_derive_shared_state;
     int  checkpoint_nfiles;
     int  regrid_on_restart;
     int  force_regrid_level_zero;
@@ -116,6 +117,7 @@ Amr::Initialize ()
     probinit_natonce         = 512;
 #endif
     plot_files_output        = true;
+    plot_derive_shared_state = false;
     checkpoint_nfiles        = 64;
     regrid_on_restart        = 0;
     force_regrid_level_zero  = 0;
@@ -152,6 +154,8 @@ Amr::Finalize ()
 
 bool Amr::Plot_Files_Output () { return plot_files_output; }
 
+bool Amr::PlotDeriveSharedState () { return plot_derive_shared_state; }
+
 std::ostream&
 Amr::DataLog (int i)
 {
@@ -330,6 +334,9 @@ Amr::InitAmr ()
     level_steps.resize(nlev);
     level_count.resize(nlev);
     n_cycle.resize(nlev);
+    level_advance_time.resize(nlev, 0.0);
+    level_advance_count.resize(nlev, 0);
+    level_cost.resize(nlev, 0.0);
     dt_min.resize(nlev);
     amr_level.resize(nlev);
     //
@@ -722,6 +729,19 @@ Amr::deleteDeriveSmallPlotVar (const std::string& name)
 
 Amr::~Amr ()
 {
+    //
+    // Renaming a pending checkpoint needs all the processes (see finalize),
+    // which a destructor cannot rely on, so only wait for our own writes.
+    //
+    if (!pending_checkpoint.empty()) {
+        AsyncOut::Finish();
+        if (ParallelDescriptor::IOProcessor()) {
+            amrex::Warning("Amr::~Amr: checkpoint " + pending_checkpoint
+                           + " was not finalized and is left in " + pending_checkpoint
+                           + ".temp; call Amr::finalize before destroying Amr");
+        }
+    }
+
     levelbld->variableCleanUp();
 
     Amr::Finalize();
@@ -1733,8 +1753,13 @@ Amr::checkPoint ()
   amrex::StreamRetry sretry(ckfile, abort_on_stream_retry_failure,
                              stream_max_tries);
 
-  // For AsyncOut, we need to turn off stream retry and write to ckfile directly.
-  const std::string ckfileTemp = (AsyncOut::UseAsyncOut()) ? ckfile : (ckfile + ".temp");
+  // For AsyncOut, we need to turn off stream retry.  The data are still
+  // written to ckfileTemp, which finalizeAsyncCheckPoint renames once the
+  // background writes have finished on all processes.
+  const std::string ckfileTemp = ckfile + ".temp";
+
+  // Only one checkpoint can be in flight.
+  finalizeAsyncCheckPoint(true);
 
   while(sretry.TryFileOutput()) {
 
@@ -1859,6 +1884,14 @@ Amr::checkPoint ()
     }
 
     if (AsyncOut::UseAsyncOut()) {
+        //
+        // Jobs run in the order they are submitted, so this runs after all
+        // of this process's writes to ckfileTemp.
+        //
+        pending_checkpoint = ckfile;
+        pending_checkpoint_start = dCheckPointTime0;
+        pending_checkpoint_done = std::make_shared<std::atomic<bool> >(false);
+        AsyncOut::Submit([done=pending_checkpoint_done] () { *done = true; });
         break;
     } else {
         ParallelDescriptor::Barrier("Amr::checkPoint::end");
@@ -1882,6 +1915,51 @@ Amr::checkPoint ()
   BL_PROFILE_REGION_STOP("Amr::checkPoint()");
 }
 
+bool
+Amr::finalizeAsyncCheckPoint (bool wait)
+{
+    if (pending_checkpoint.empty()) { return true; }
+
+    BL_PROFILE("Amr::finalizeAsyncCheckPoint()");
+
+    if (wait) {
+        AsyncOut::Finish();
+    }
+
+    bool done = *pending_checkpoint_done;
+    ParallelDescriptor::ReduceBoolAnd(done);
+    if (!done) { return false; }
+
+    const std::string ckfileTemp = pending_checkpoint + ".temp";
+    if (ParallelDescriptor::IOProcessor()) {
+        if (std::rename(ckfileTemp.c_str(), pending_checkpoint.c_str())) {
+            amrex::Abort("Amr::finalizeAsyncCheckPoint: std::rename failed");
+        }
+    }
+    ParallelDescriptor::Barrier("Renaming temporary checkPoint file.");
+
+    if (verbose > 0) {
+        auto dCheckPointTime = amrex::second() - pending_checkpoint_start;
+        ParallelDescriptor::ReduceRealMax(dCheckPointTime,
+                                          ParallelDescriptor::IOProcessorNumber());
+        amrex::Print() << "CHECKPOINT: file = " << pending_checkpoint
+                       << " finished writing after " << dCheckPointTime << " secs." << '\n';
+    }
+    if (record_run_info && ParallelDescriptor::IOProcessor()) {
+        runlog << "CHECKPOINT: file = " << pending_checkpoint << " finished writing" << '\n';
+    }
+
+    pending_checkpoint.clear();
+    pending_checkpoint_done.reset();
+    return true;
+}
+
+void
+Amr::finalize ()
+{
+    finalizeAsyncCheckPoint(true);
+}
+
 void
 Amr::RegridOnly (Real time, bool do_io)
 {
@@ -2021,9 +2099,14 @@ Amr::timeStep (int  level,
                        << " with dt = " << dt_level[level] << "\n";
     }
 
+    const double advance_strt = amrex::second();
+
     Real dt_new = amr_level[level]->advance(time,dt_level[level],iteration,niter);
     BL_PROFILE_REGION_STOP("amr_level.advance");
 
+    level_advance_time[level] += amrex::second() - advance_strt;
+    level_advance_count[level]++;
+
     dt_min[level] = iteration == 1 ? dt_new : std::min(dt_min[level],dt_new);
 
     level_steps[level]++;
@@ -2108,6 +2191,10 @@ Amr::coarseTimeStep (Real stop_time)
     //
     if (levelSteps(0) > 0)
     {
+        if (subcycling_mode == "CostAware") {
+            computeCostAwareSubcycling();
+        }
+
         int post_regrid_flag = 0;
         amr_level[0]->computeNewDt(finest_level,
                                    sub_cycle,
@@ -2128,6 +2215,11 @@ Amr::coarseTimeStep (Real stop_time)
                                        stop_time);
     }
 
+    for (int lev = 0; lev <= max_level; ++lev) {
+        level_advance_time[lev] = 0.0;
+        level_advance_count[lev] = 0;
+    }
+
     BL_PROFILE_REGION_START(stepName.str());
     timeStep(0,cumtime,1,1,stop_time);
     BL_PROFILE_REGION_STOP(stepName.str());
@@ -2212,6 +2304,9 @@ Amr::coarseTimeStep (Real stop_time)
         runlog_terse.flush();
     }
 
+    // Finish up a checkpoint written in the background during this step.
+    finalizeAsyncCheckPoint(false);
+
     int check_test = 0;
 
     if (check_per > 0.0)
@@ -2635,6 +2730,10 @@ Amr::regrid (int  lbase,
         amr_level[lev].reset();
         this->ClearBoxArray(lev);
         this->ClearDistributionMap(lev);
+        //
+        // A level created again later must be measured anew.
+        //
+        level_cost[lev] = 0.0;
     }
 
     finest_level = new_finest;
@@ -3202,15 +3301,22 @@ Amr::initSubcycle ()
             n_cycle[i] = MaxRefRatio(i-1);
         }
     }
-    else if (subcycling_mode == "Optimal")
+    else if (subcycling_mode == "Optimal" || subcycling_mode == "CostAware")
     {
-        // if subcycling mode is Optimal, n_cycle is set dynamically.
+        // if subcycling mode is Optimal or CostAware, n_cycle is set dynamically.
         // We'll initialize it to be Auto subcycling.
         n_cycle[0] = 1;
         for (int i = 1; i <= max_level; i++)
         {
             n_cycle[i] = MaxRefRatio(i-1);
         }
+        if (subcycling_mode == "CostAware")
+        {
+            pp.queryAdd("subcycling_cost_smoothing", subcycling_cost_smoothing);
+            if (subcycling_cost_smoothing <= 0.0 || subcycling_cost_smoothing > 1.0) {
+                amrex::Error("subcycling_cost_smoothing must be in (0,1]");
+            }
+        }
     }
     else
     {
@@ -3226,6 +3332,7 @@ Amr::initPltAndChk ()
 
     pp.queryAdd("checkpoint_files_output", checkpoint_files_output);
     pp.queryAdd("plot_files_output", plot_files_output);
+    pp.queryAdd("plot_derive_shared_state", plot_derive_shared_state);
 
     pp.queryAdd("plot_nfiles", plot_nfiles);
     pp.queryAdd("checkpoint_nfiles", checkpoint_nfiles);
@@ -3381,6 +3488,84 @@ Amr::computeOptimalSubcycling(int n, int* best, const Real* dt_max, const Real*
     return best_dt;
 }
 
+void
+Amr::computeCostAwareSubcycling ()
+{
+    BL_PROFILE("Amr::computeCostAwareSubcycling()");
+
+    const int nlev = finest_level+1;
+    if (nlev < 2) { return; }
+
+    //
+    // The max over ranks is what the step actually costs, so the load
+    // imbalance at each level is already part of the cost.
+    //
+    Vector<Real> tmax(nlev);
+    for (int lev = 0; lev < nlev; ++lev) {
+        tmax[lev] = level_advance_time[lev];
+    }
+    ParallelDescriptor::ReduceRealMax(tmax.data(), nlev);
+
+    for (int lev = 0; lev < nlev; ++lev)
+    {
+        if (level_advance_count[lev] > 0)
+        {
+            const Real cost = tmax[lev] / static_cast<Real>(level_advance_count[lev]);
+            level_cost[lev] = (level_cost[lev] > 0.0)
+                ? subcycling_cost_smoothing*cost + (1.0_rt-subcycling_cost_smoothing)*level_cost[lev]
+                : cost;
+        }
+    }
+
+    //
+    // Keep the current pattern until every level has been measured and
+    // has a valid dt estimate (e.g., right after a new level is created).
+    //
+    for (int lev = 0; lev < nlev; ++lev) {
+        if (level_cost[lev] <= 0.0 || dt_min[lev] <= 0.0) { return; }
+    }
+
+    Vector<int> best(nlev), cycle_max(nlev);
+    cycle_max[0] = 1;
+    for (int lev = 1; lev < nlev; ++lev) {
+        cycle_max[lev] = MaxRefRatio(lev-1);
+    }
+
+    computeOptimalSubcycling(nlev, best.data(), dt_min.data(), level_cost.data(), cycle_max.data());
+
+    // Projected wall time per unit of simulated time for a subcycling pattern
+    auto projected = [&] (Vector<int> const& ncyc) -> Real
+    {
+        Real dt = dt_min[0];
+        Real work = level_cost[0];
+        int nsteps = 1;
+        for (int lev = 1; lev < nlev; ++lev) {
+            nsteps *= ncyc[lev];
+            dt = std::min(dt, static_cast<Real>(nsteps)*dt_min[lev]);
+            work += static_cast<Real>(nsteps)*level_cost[lev];
+        }
+        return work/dt;
+    };
+    const Real old_rate = projected(n_cycle);
+    const Real new_rate = projected(best);
+
+    for (int lev = 1; lev < nlev; ++lev) {
+        n_cycle[lev] = best[lev];
+    }
+
+    if (verbose > 0)
+    {
+        amrex::Print() << "[STEP " << level_steps[0] << "] CostAware subcycling:";
+        for (int lev = 0; lev < nlev; ++lev) {
+            amrex::Print() << "\n    level " << lev
+                           << ": cost/step = " << level_cost[lev]
+                           << " n_cycle = " << n_cycle[lev];
+        }
+        amrex::Print() << "\n    projected wall time per unit time: "
+                       << old_rate << " -> " << new_rate << "\n";
+    }
+}
+
 const Vector<BoxArray>& Amr::getInitialBA() noexcept
 {
   return initial_ba;
@@ -156,7 +156,7 @@ AmrLevel::writePlotFile (const std::string& dir,
     }
 
     int num_derive = 0;
-    std::vector<std::string> derive_names;
+    Vector<std::string> derive_names;
     const std::list<DeriveRec>& dlist = derive_lst.dlist();
     for (auto const& d : dlist)
     {
@@ -338,10 +338,21 @@ AmrLevel::writePlotFile (const std::string& dir,
     // derived
     if (!derive_names.empty())
     {
-        for (auto const& dname : derive_names)
-        {
-            derive(dname, cur_time, plotMF, cnt);
-            cnt += derive_lst.get(dname)->numDerive();
+        //
+        // Optionally FillPatch the state once and share it among all the
+        // derived quantities.  This is off by default because deriveMany
+        // bypasses derive() for names in the derive list, which classes
+        // overriding derive() may not expect.
+        //
+        if (Amr::PlotDeriveSharedState()) {
+            deriveMany(derive_names, cur_time, plotMF, cnt);
+            cnt += num_derive;
+        } else {
+            for (auto const& dname : derive_names)
+            {
+                derive(dname, cur_time, plotMF, cnt);
+                cnt += derive_lst.get(dname)->numDerive();
+            }
         }
     }
 
@@ -1769,81 +1780,202 @@ AmrLevel::derive (const std::string& name, Real time, MultiFab& mf, int dcomp)
             FillPatch(*this,srcMF,ngrow_src,time,index,scomp,ncomp,dc);
         }
 
-        if (rec->derFuncFab() != nullptr)
-        {
+        deriveFromSource(*rec, index, time, mf, dcomp, srcMF);
+    }
+    else
+    {
+        //
+        // If we got here, cannot derive given name.
+        //
+        std::string msg("AmrLevel::derive(MultiFab*): unknown variable: ");
+        msg += name;
+        amrex::Error(msg.c_str());
+    }
+}
+
+
+void
+AmrLevel::deriveFromSource (const DeriveRec& rec, int index, Real time,
+                            MultiFab& mf, int dcomp, MultiFab& srcMF)
+{
+    if (rec.derFuncFab() != nullptr)
+    {
 #ifdef AMREX_USE_OMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
-            for (MFIter mfi(mf,TilingIfNotGPU()); mfi.isValid(); ++mfi)
-            {
-                const Box& bx = mfi.growntilebox();
-                FArrayBox& derfab = mf[mfi];
-                FArrayBox const& datafab = srcMF[mfi];
-                const int dncomp = rec->numDerive();
-                rec->derFuncFab()(bx, derfab, dcomp, dncomp, datafab, geom, time, rec->getBC(), level);
-            }
-        }
-        else if (rec->derFuncMF() != nullptr)
+        for (MFIter mfi(mf,TilingIfNotGPU()); mfi.isValid(); ++mfi)
         {
-            const int dncomp = rec->numDerive();
-            rec->derFuncMF()(mf, dcomp, dncomp, srcMF, geom, time, rec->getBC(), level);
+            const Box& bx = mfi.growntilebox();
+            FArrayBox& derfab = mf[mfi];
+            FArrayBox const& datafab = srcMF[mfi];
+            const int dncomp = rec.numDerive();
+            rec.derFuncFab()(bx, derfab, dcomp, dncomp, datafab, geom, time, rec.getBC(), level);
         }
-        else
-        {
+    }
+    else if (rec.derFuncMF() != nullptr)
+    {
+        const int dncomp = rec.numDerive();
+        rec.derFuncMF()(mf, dcomp, dncomp, srcMF, geom, time, rec.getBC(), level);
+    }
+    else
+    {
 #ifdef AMREX_USE_OMP
 #pragma omp parallel
 #endif
-        for (MFIter mfi(mf,true); mfi.isValid(); ++mfi)
-        {
-            int         idx     = mfi.index();
-            Real*       ddat    = mf[mfi].dataPtr(dcomp);
-            const int*  dlo     = mf[mfi].loVect();
-            const int*  dhi     = mf[mfi].hiVect();
-            const Box&  gtbx    = mfi.growntilebox();
-            const int*  lo      = gtbx.loVect();
-            const int*  hi      = gtbx.hiVect();
-            int         n_der   = rec->numDerive();
-            Real*       cdat    = srcMF[mfi].dataPtr();
-            const int*  clo     = srcMF[mfi].loVect();
-            const int*  chi     = srcMF[mfi].hiVect();
-            int         n_state = rec->numState();
-            const int*  dom_lo  = state[index].getDomain().loVect();
-            const int*  dom_hi  = state[index].getDomain().hiVect();
-            const Real* dx      = geom.CellSize();
-            const int*  bcr     = rec->getBC();
-            const RealBox& temp = RealBox(gtbx,geom.CellSize(),geom.ProbLo());
-            const Real* xlo     = temp.lo();
-            Real        dt      = parent->dtLevel(level);
+    for (MFIter mfi(mf,true); mfi.isValid(); ++mfi)
+    {
+        int         idx     = mfi.index();
+        Real*       ddat    = mf[mfi].dataPtr(dcomp);
+        const int*  dlo     = mf[mfi].loVect();
+        const int*  dhi     = mf[mfi].hiVect();
+        const Box&  gtbx    = mfi.growntilebox();
+        const int*  lo      = gtbx.loVect();
+        const int*  hi      = gtbx.hiVect();
+        int         n_der   = rec.numDerive();
+        Real*       cdat    = srcMF[mfi].dataPtr();
+        const int*  clo     = srcMF[mfi].loVect();
+        const int*  chi     = srcMF[mfi].hiVect();
+        int         n_state = rec.numState();
+        const int*  dom_lo  = state[index].getDomain().loVect();
+        const int*  dom_hi  = state[index].getDomain().hiVect();
+        const Real* dx      = geom.CellSize();
+        const int*  bcr     = rec.getBC();
+        const RealBox& temp = RealBox(gtbx,geom.CellSize(),geom.ProbLo());
+        const Real* xlo     = temp.lo();
+        Real        dt      = parent->dtLevel(level);
+
+        if (rec.derFunc() != nullptr) {
+           rec.derFunc()(ddat,AMREX_ARLIM(dlo),AMREX_ARLIM(dhi),&n_der,
+                          cdat,AMREX_ARLIM(clo),AMREX_ARLIM(chi),&n_state,
+                          lo,hi,dom_lo,dom_hi,dx,xlo,&time,&dt,bcr,
+                          &level,&idx);
+        } else if (rec.derFunc3D() != nullptr) {
+           const int *bc3D = rec.getBC3D();
+           rec.derFunc3D()(ddat,AMREX_ARLIM_3D(dlo),AMREX_ARLIM_3D(dhi),&n_der,
+                            cdat,AMREX_ARLIM_3D(clo),AMREX_ARLIM_3D(chi),&n_state,
+                            AMREX_ARLIM_3D(lo),AMREX_ARLIM_3D(hi),
+                            AMREX_ARLIM_3D(dom_lo),AMREX_ARLIM_3D(dom_hi),
+                            AMREX_ZFILL(dx),AMREX_ZFILL(xlo),
+                            &time,&dt,
+                            bc3D,
+                            &level,&idx);
+        } else {
+           amrex::Error("AmrLevel::derive: no function available");
+        }
+    }
+    }
+}
 
-            if (rec->derFunc() != nullptr) {
-               rec->derFunc()(ddat,AMREX_ARLIM(dlo),AMREX_ARLIM(dhi),&n_der,
-                              cdat,AMREX_ARLIM(clo),AMREX_ARLIM(chi),&n_state,
-                              lo,hi,dom_lo,dom_hi,dx,xlo,&time,&dt,bcr,
-                              &level,&idx);
-            } else if (rec->derFunc3D() != nullptr) {
-               const int *bc3D = rec->getBC3D();
-               rec->derFunc3D()(ddat,AMREX_ARLIM_3D(dlo),AMREX_ARLIM_3D(dhi),&n_der,
-                                cdat,AMREX_ARLIM_3D(clo),AMREX_ARLIM_3D(chi),&n_state,
-                                AMREX_ARLIM_3D(lo),AMREX_ARLIM_3D(hi),
-                                AMREX_ARLIM_3D(dom_lo),AMREX_ARLIM_3D(dom_hi),
-                                AMREX_ZFILL(dx),AMREX_ZFILL(xlo),
-                                &time,&dt,
-                                bc3D,
-                                &level,&idx);
-            } else {
-               amrex::Error("AmrLevel::derive: no function available");
+void
+AmrLevel::deriveMany (const Vector<std::string>& names, Real time, MultiFab& mf, int dcomp)
+{
+    BL_PROFILE("AmrLevel::deriveMany()");
+
+    const int ngrow = mf.nGrow();
+    const int nstate = desc_lst.size();
+
+    auto is_shared = [] (const std::string& name) -> const DeriveRec*
+    {
+        int index, scomp;
+        if (isStateVariable(name, index, scomp)) { return nullptr; }
+        return derive_lst.get(name);
+    };
+
+    auto src_nghost = [&] (const DeriveRec* rec) -> int
+    {
+        int index, scomp, ncomp;
+        rec->getRange(0, index, scomp, ncomp);
+        const Box bx0 = state[index].boxArray()[0];
+        const Box bx1 = rec->boxMap()(bx0);
+        return ngrow + bx0.smallEnd(0) - bx1.smallEnd(0);
+    };
+
+    //
+    // For each state type, the components and the number of ghost cells
+    // needed by all of the derived quantities together.  Only the needed
+    // components are filled, packed in order, so that comp_map[index][c]
+    // is where component c of state type index is stored.
+    //
+    Vector<Vector<int> > comp_map(nstate);
+    Vector<int> ngrow_state(nstate, -1);
+    for (auto const& name : names)
+    {
+        const DeriveRec* rec = is_shared(name);
+        if (rec == nullptr) { continue; }
+
+        const int ngrow_src = src_nghost(rec);
+        int index, scomp, ncomp;
+        for (int k = 0; k < rec->numRange(); ++k)
+        {
+            rec->getRange(k, index, scomp, ncomp);
+            if (comp_map[index].empty()) {
+                comp_map[index].resize(desc_lst[index].nComp(), -1);
             }
+            for (int n = scomp; n < scomp+ncomp; ++n) { comp_map[index][n] = 0; }
+            ngrow_state[index] = std::max(ngrow_state[index], ngrow_src);
         }
+    }
+
+    Vector<std::unique_ptr<MultiFab> > stateMF(nstate);
+    for (int index = 0; index < nstate; ++index)
+    {
+        auto& cmap = comp_map[index];
+        if (cmap.empty()) { continue; }
+        const int nstatecomp = static_cast<int>(cmap.size());
+        int ncomp = 0;
+        for (auto& c : cmap) {
+            if (c >= 0) { c = ncomp++; }
+        }
+        stateMF[index] = std::make_unique<MultiFab>(state[index].boxArray(), dmap, ncomp,
+                                                    ngrow_state[index], MFInfo(), *m_factory);
+        // FillPatch each run of consecutive needed components
+        for (int n = 0; n < nstatecomp; )
+        {
+            if (cmap[n] < 0) { ++n; continue; }
+            int nrun = 1;
+            while (n+nrun < nstatecomp && cmap[n+nrun] >= 0) { ++nrun; }
+            FillPatch(*this, *stateMF[index], ngrow_state[index], time, index, n, nrun, cmap[n]);
+            n += nrun;
         }
     }
-    else
+
+    int dc = dcomp;
+    for (auto const& name : names)
     {
-        //
-        // If we got here, cannot derive given name.
-        //
-        std::string msg("AmrLevel::derive(MultiFab*): unknown variable: ");
-        msg += name;
-        amrex::Error(msg.c_str());
+        const DeriveRec* rec = is_shared(name);
+        if (rec == nullptr)
+        {
+            derive(name, time, mf, dc);
+            int index, scomp;
+            const DeriveRec* drec = derive_lst.get(name);
+            dc += (drec != nullptr && !isStateVariable(name, index, scomp)) ? drec->numDerive() : 1;
+            continue;
+        }
+
+        int index, scomp, ncomp;
+        rec->getRange(0, index, scomp, ncomp);
+
+        if (rec->numRange() == 1)
+        {
+            // The needed components are packed in order, so a single range is
+            // a contiguous piece of the shared state; just alias it.
+            MultiFab srcMF(*stateMF[index], amrex::make_alias, comp_map[index][scomp], ncomp);
+            deriveFromSource(*rec, index, time, mf, dc, srcMF);
+        }
+        else
+        {
+            const int ngrow_src = src_nghost(rec);
+            MultiFab srcMF(state[index].boxArray(), dmap, rec->numState(), ngrow_src,
+                           MFInfo(), *m_factory);
+            for (int k = 0, sc = 0; k < rec->numRange(); k++, sc += ncomp)
+            {
+                rec->getRange(k, index, scomp, ncomp);
+                MultiFab::Copy(srcMF, *stateMF[index], comp_map[index][scomp], sc, ncomp, ngrow_src);
+            }
+            deriveFromSource(*rec, index, time, mf, dc, srcMF);
+        }
+
+        dc += rec->numDerive();
     }
 }
 
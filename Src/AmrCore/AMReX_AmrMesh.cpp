@@ -381,6 +381,8 @@ AmrMesh::InitAmrMesh (int max_level_in, const Vector<int>& n_cell_in,
 
     pp.queryAdd("check_input", check_input);
 
+    pp.queryAdd("use_sparse_tags", use_sparse_tags);
+
     finest_level = -1;
 
 #ifdef AMREX_USE_BITTREE
@@ -663,16 +665,34 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
             ErrorEst(levc, tags, time, 0);
         }
 
+        //
+        // Optionally switch to a list of the tagged cells for buffering and
+        // coarsening, which only touches the tags instead of every cell.
+        //
+        std::unique_ptr<SparseTagBoxArray> stags;
+        if (use_sparse_tags) {
+            stags = std::make_unique<SparseTagBoxArray>(tags);
+            tags.clear();
+        }
+
         //
         // Buffer error cells.
         //
-        tags.buffer(n_error_buf[levc]);
+        if (stags) {
+            stags->buffer(n_error_buf[levc]);
+        } else {
+            tags.buffer(n_error_buf[levc]);
+        }
 
         if (useFixedCoarseGrids())
         {
             if (levc>=useFixedUpToLevel())
             {
-                tags.setVal(GetAreaNotToTag(levc), TagBox::CLEAR);
+                if (stags) {
+                    stags->setVal(GetAreaNotToTag(levc), TagBox::CLEAR);
+                } else {
+                    tags.setVal(GetAreaNotToTag(levc), TagBox::CLEAR);
+                }
             }
             else
             {
@@ -688,7 +708,14 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
             bl_max = std::max(bl_max,bf_lev[levc][n]);
         }
         if (bl_max >= 1) {
-            tags.coarsen(bf_lev[levc]);
+            if (stags) {
+                stags->coarsen(bf_lev[levc]);
+                tags = TagBoxArray(stags->boxArray(), stags->DistributionMap(), stags->nGrowVect());
+                stags->copyTo(tags);
+                stags.reset();
+            } else {
+                tags.coarsen(bf_lev[levc]);
+            }
         } else {
             amrex::Abort("blocking factor is too small relative to ref_ratio");
         }
@@ -707,23 +734,45 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
             tags.setVal(ba_proj,TagBox::SET);
         }
         //
+        // The rest only needs the tagged cells, so switch back to the sparse
+        // form, now at the coarsened resolution.
+        //
+        if (use_sparse_tags) {
+            stags = std::make_unique<SparseTagBoxArray>(tags);
+            tags.clear();
+        }
+        //
         // Map tagged points through periodic boundaries, if any.
         //
-        tags.mapPeriodicRemoveDuplicates(Geometry(pc_domain[levc],
-                                                  Geom(levc).ProbDomain(),
-                                                  Geom(levc).CoordInt(),
-                                                  Geom(levc).isPeriodic()));
+        const Geometry pc_geom(pc_domain[levc],
+                               Geom(levc).ProbDomain(),
+                               Geom(levc).CoordInt(),
+                               Geom(levc).isPeriodic());
+        if (stags) {
+            stags->mapPeriodicRemoveDuplicates(pc_geom);
+        } else {
+            tags.mapPeriodicRemoveDuplicates(pc_geom);
+        }
         //
         // Remove cells outside proper nesting domain for this level.
         //
-        tags.setVal(p_n_comp_ba[levc],TagBox::CLEAR);
+        if (stags) {
+            stags->setVal(p_n_comp_ba[levc],TagBox::CLEAR);
+        } else {
+            tags.setVal(p_n_comp_ba[levc],TagBox::CLEAR);
+        }
         p_n_comp_ba[levc].clear();
         //
         // Create initial cluster containing all tagged points.
         //
         Gpu::PinnedVector<IntVect> tagvec;
-        tags.collate(tagvec);
-        tags.clear();
+        if (stags) {
+            stags->collate(tagvec);
+            stags.reset();
+        } else {
+            tags.collate(tagvec);
+            tags.clear();
+        }
 
         if (!tagvec.empty())
         {
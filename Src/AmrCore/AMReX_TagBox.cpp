@@ -787,4 +787,379 @@ TagBoxArray::hasTags (Box const& a_bx) const
     return has_tags;
 }
 
+
+namespace {
+    void sort_unique (Vector<IntVect>& v)
+    {
+        std::sort(v.begin(), v.end());
+        v.erase(std::unique(v.begin(), v.end()), v.end());
+    }
+}
+
+void
+SparseTagBoxArray::sort_unique (Vector<Tag>& tags)
+{
+    std::sort(tags.begin(), tags.end(),
+              [] (Tag const& a, Tag const& b) { return a.iv < b.iv; });
+    Long n = 0;
+    for (Long m = 0, N = static_cast<Long>(tags.size()); m < N; ++m) {
+        if (n > 0 && tags[n-1].iv == tags[m].iv) {
+            tags[n-1].val = std::max(tags[n-1].val, tags[m].val);
+        } else {
+            tags[n++] = tags[m];
+        }
+    }
+    tags.resize(n);
+}
+
+SparseTagBoxArray::SparseTagBoxArray (const TagBoxArray& tags)
+    : m_ba(tags.boxArray()),
+      m_dm(tags.DistributionMap()),
+      m_ngrow(tags.nGrowVect()),
+      m_cells(tags.boxArray(), tags.DistributionMap())
+{
+    BL_PROFILE("SparseTagBoxArray::SparseTagBoxArray()");
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(tags); mfi.isValid(); ++mfi)
+    {
+        Box const& bx = mfi.fabbox();
+        Array4<char const> arr = tags.const_array(mfi);
+#ifdef AMREX_USE_GPU
+        TagBox hfab;
+        if (Gpu::inLaunchRegion()) {
+            hfab.resize(bx, 1, The_Pinned_Arena());
+            Gpu::dtoh_memcpy_async(hfab.dataPtr(), tags[mfi].dataPtr(), hfab.nBytes());
+            Gpu::streamSynchronize();
+            arr = hfab.const_array();
+        }
+#endif
+        auto& cells = m_cells[mfi];
+        AMREX_LOOP_3D(bx, i, j, k,
+        {
+            if (arr(i,j,k) != TagBox::CLEAR) {
+                cells.push_back(Tag{IntVect(AMREX_D_DECL(i,j,k)), arr(i,j,k)});
+            }
+        });
+    }
+}
+
+void
+SparseTagBoxArray::buffer (const IntVect& nbuf)
+{
+    BL_PROFILE("SparseTagBoxArray::buffer()");
+
+    AMREX_ASSERT(nbuf.allLE(m_ngrow));
+
+    if (nbuf.max() <= 0) { return; }
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(m_cells); mfi.isValid(); ++mfi)
+    {
+        Box const& vbx = m_ba[mfi.index()];
+        auto& cells = m_cells[mfi];
+
+        // As in TagBox::buffer, only SET tags in the valid region are buffered.
+        Vector<IntVect> buffered;
+        for (auto const& tag : cells) {
+            if (tag.val == TagBox::SET && vbx.contains(tag.iv)) { buffered.push_back(tag.iv); }
+        }
+
+        // A box shaped buffer is separable, so grow one direction at a time.
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+        {
+            if (nbuf[idim] == 0) { continue; }
+            const auto n = static_cast<Long>(buffered.size());
+            buffered.reserve(n*(2*nbuf[idim]+1));
+            for (Long m = 0; m < n; ++m) {
+                for (int s = -nbuf[idim]; s <= nbuf[idim]; ++s) {
+                    if (s != 0) {
+                        IntVect iv = buffered[m];
+                        iv[idim] += s;
+                        buffered.push_back(iv);
+                    }
+                }
+            }
+            amrex::sort_unique(buffered);
+        }
+
+        // Merging keeps the value of cells that were already tagged.
+        for (auto const& iv : buffered) {
+            cells.push_back(Tag{iv, TagBox::BUF});
+        }
+        sort_unique(cells);
+    }
+}
+
+void
+SparseTagBoxArray::setVal (const BoxArray& ba, TagBox::TagVal val)
+{
+    BL_PROFILE("SparseTagBoxArray::setVal()");
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+    {
+        std::vector< std::pair<int,Box> > isects;
+        for (MFIter mfi(m_cells); mfi.isValid(); ++mfi)
+        {
+            ba.intersections(fabbox(mfi.index()), isects);
+            if (isects.empty()) { continue; }
+
+            // Remove the cells in ba, and add them back with the new value.
+            auto& cells = m_cells[mfi];
+            auto covered = [&] (Tag const& tag) -> bool
+            {
+                for (auto const& is : isects) {
+                    if (is.second.contains(tag.iv)) { return true; }
+                }
+                return false;
+            };
+            cells.erase(std::remove_if(cells.begin(), cells.end(), covered), cells.end());
+
+            if (val != TagBox::CLEAR)
+            {
+                const auto v = static_cast<TagBox::TagType>(val);
+                for (auto const& is : isects) {
+                    AMREX_LOOP_3D(is.second, i, j, k,
+                    {
+                        cells.push_back(Tag{IntVect(AMREX_D_DECL(i,j,k)), v});
+                    });
+                }
+                sort_unique(cells);
+            }
+        }
+    }
+}
+
+void
+SparseTagBoxArray::coarsen (const IntVect& ratio)
+{
+    BL_PROFILE("SparseTagBoxArray::coarsen()");
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(m_cells); mfi.isValid(); ++mfi)
+    {
+        auto& cells = m_cells[mfi];
+        for (auto& tag : cells) {
+            tag.iv.coarsen(ratio);
+        }
+        sort_unique(cells);
+    }
+
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        m_ngrow[idim] = (m_ngrow[idim]+ratio[idim]-1)/ratio[idim];
+    }
+    m_ba.coarsen(ratio);
+}
+
+void
+SparseTagBoxArray::mapPeriodicRemoveDuplicates (const Geometry& geom)
+{
+    BL_PROFILE("SparseTagBoxArray::mapPRD");
+
+    const int nprocs = ParallelContext::NProcsSub();
+    const std::vector<IntVect>& pshifts = geom.periodicity().shiftIntVect();
+    const Box gdomain = amrex::grow(geom.Domain(), m_ngrow);
+
+    //
+    // As in TagBoxArray::mapPeriodicRemoveDuplicates, every tagged cell and
+    // its periodic images are kept wherever they fall in a box including
+    // ghost cells, and each of these cells is owned by the lowest numbered
+    // box containing it.
+    //
+    Vector<Vector<int> > send_data(nprocs);
+    std::vector< std::pair<int,Box> > isects;
+    for (MFIter mfi(m_cells); mfi.isValid(); ++mfi)
+    {
+        auto& cells = m_cells[mfi];
+        Vector<Tag> keep;
+        for (auto const& tag : cells)
+        {
+            for (auto const& shift : pshifts)
+            {
+                const IntVect iv = tag.iv + shift;
+                if (!gdomain.contains(iv)) { continue; }
+
+                m_ba.intersections(Box(iv,iv), isects, false, m_ngrow);
+                if (isects.empty()) { continue; }
+                int owner = isects[0].first;
+                for (auto const& is : isects) {
+                    owner = std::min(owner, is.first);
+                }
+
+                if (owner == mfi.index()) {
+                    keep.push_back(Tag{iv, tag.val});
+                } else {
+                    auto& buf = send_data[ParallelContext::global_to_local_rank(m_dm[owner])];
+                    buf.push_back(owner);
+                    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                        buf.push_back(iv[idim]);
+                    }
+                    buf.push_back(tag.val);
+                }
+            }
+        }
+        cells = std::move(keep);
+    }
+
+    constexpr int nints = AMREX_SPACEDIM+2;
+    auto unpack = [&] (int const* p, Long n)
+    {
+        for (Long m = 0; m < n; m += nints) {
+            m_cells[p[m]].push_back(Tag{IntVect(AMREX_D_DECL(p[m+1],p[m+2],p[m+3])),
+                                        static_cast<TagBox::TagType>(p[m+1+AMREX_SPACEDIM])});
+        }
+    };
+
+#ifdef BL_USE_MPI
+    if (nprocs > 1)
+    {
+        Vector<int> send_count(nprocs), recv_count(nprocs);
+        Vector<int> send_offset(nprocs,0), recv_offset(nprocs,0);
+        Vector<int> send_buf;
+        for (int i = 0; i < nprocs; ++i) {
+            send_count[i] = static_cast<int>(send_data[i].size());
+            send_offset[i] = static_cast<int>(send_buf.size());
+            send_buf.insert(send_buf.end(), send_data[i].begin(), send_data[i].end());
+        }
+
+        BL_MPI_REQUIRE( MPI_Alltoall(send_count.dataPtr(), 1, MPI_INT,
+                                     recv_count.dataPtr(), 1, MPI_INT,
+                                     ParallelContext::CommunicatorSub()) );
+
+        for (int i = 1; i < nprocs; ++i) {
+            recv_offset[i] = recv_offset[i-1] + recv_count[i-1];
+        }
+        Vector<int> recv_buf(recv_offset[nprocs-1] + recv_count[nprocs-1]);
+
+        BL_MPI_REQUIRE( MPI_Alltoallv(send_buf.dataPtr(), send_count.dataPtr(),
+                                      send_offset.dataPtr(), MPI_INT,
+                                      recv_buf.dataPtr(), recv_count.dataPtr(),
+                                      recv_offset.dataPtr(), MPI_INT,
+                                      ParallelContext::CommunicatorSub()) );
+
+        unpack(recv_buf.dataPtr(), static_cast<Long>(recv_buf.size()));
+    }
+    else
+#endif
+    {
+        unpack(send_data[0].dataPtr(), static_cast<Long>(send_data[0].size()));
+    }
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(m_cells); mfi.isValid(); ++mfi) {
+        sort_unique(m_cells[mfi]);
+    }
+}
+
+void
+SparseTagBoxArray::collate (Gpu::PinnedVector<IntVect>& TheGlobalCollateSpace) const
+{
+    BL_PROFILE("SparseTagBoxArray::collate()");
+
+    Vector<IntVect> local;
+    for (MFIter mfi(m_cells); mfi.isValid(); ++mfi) {
+        for (auto const& tag : m_cells[mfi]) {
+            local.push_back(tag.iv);
+        }
+    }
+
+    Long count = static_cast<Long>(local.size());
+    Long numtags = count;
+    ParallelDescriptor::ReduceLongSum(numtags);
+
+    if (numtags == 0) {
+        TheGlobalCollateSpace.clear();
+        return;
+    } else if (numtags > static_cast<Long>(std::numeric_limits<int>::max())) {
+        amrex::Abort("SparseTagBoxArray::collate: Too many tags. Using a larger blocking factor might help.");
+    }
+
+#ifdef BL_USE_MPI
+    const int IOProcNumber = ParallelDescriptor::IOProcessorNumber();
+    const std::vector<int>& countvec = ParallelDescriptor::Gather(static_cast<int>(count),
+                                                                  IOProcNumber);
+    std::vector<int> offset(countvec.size(),0);
+    Vector<IntVect> global;
+    if (ParallelDescriptor::IOProcessor()) {
+        for (std::size_t i = 1, N = offset.size(); i < N; i++) {
+            offset[i] = offset[i-1] + countvec[i-1];
+        }
+        global.resize(numtags);
+    } else {
+        global.resize(1);
+    }
+    ParallelDescriptor::Gatherv(local.dataPtr(), static_cast<int>(count), global.dataPtr(),
+                                countvec, offset, IOProcNumber);
+    if (!ParallelDescriptor::IOProcessor()) {
+        // non-empty signals that the number of tags is not zero
+        TheGlobalCollateSpace.resize(1);
+        return;
+    }
+#else
+    Vector<IntVect> global = std::move(local);
+#endif
+
+    // Cells in the ghost regions of several boxes may have been kept more than once.
+    amrex::sort_unique(global);
+    TheGlobalCollateSpace.resize(global.size());
+    std::copy(global.begin(), global.end(), TheGlobalCollateSpace.begin());
+}
+
+void
+SparseTagBoxArray::copyTo (TagBoxArray& tags) const
+{
+    BL_PROFILE("SparseTagBoxArray::copyTo()");
+
+    AMREX_ASSERT(tags.boxArray() == m_ba && tags.DistributionMap() == m_dm);
+
+    tags.setVal(TagBox::CLEAR);
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(tags); mfi.isValid(); ++mfi)
+    {
+        Box const& bx = mfi.fabbox();
+        auto const& cells = m_cells[mfi];
+        if (cells.empty()) { continue; }
+#ifdef AMREX_USE_GPU
+        if (Gpu::inLaunchRegion()) {
+            TagBox hfab(bx, 1, The_Pinned_Arena());
+            hfab.setVal<RunOn::Host>(TagBox::CLEAR);
+            for (auto const& tag : cells) {
+                if (bx.contains(tag.iv)) { hfab(tag.iv) = tag.val; }
+            }
+            Gpu::htod_memcpy_async(tags[mfi].dataPtr(), hfab.dataPtr(), hfab.nBytes());
+            Gpu::streamSynchronize();
+        } else
+#endif
+        {
+            TagBox& fab = tags[mfi];
+            for (auto const& tag : cells) {
+                if (bx.contains(tag.iv)) { fab(tag.iv) = tag.val; }
+            }
+        }
+    }
+}
+
+Long
+SparseTagBoxArray::numLocalTags () const noexcept
+{
+    Long n = 0;
+    for (MFIter mfi(m_cells); mfi.isValid(); ++mfi) {
+        n += static_cast<Long>(m_cells[mfi].size());
+    }
+    return n;
+}
+
 }
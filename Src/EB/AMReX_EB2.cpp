@@ -13,8 +13,18 @@
 #include <AMReX_EB2_IndexSpace_STL.H>
 #include <AMReX_EB2_IndexSpace_chkpt_file.H>
 #include <AMReX_ParmParse.H>
+#include <AMReX_FileSystem.H>
+#include <AMReX_Utility.H>
+#include <AMReX_VisMF.H>
 #include <AMReX.H>
 #include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
 
 namespace amrex::EB2 {
 
@@ -23,6 +33,7 @@ AMREX_EXPORT Vector<std::unique_ptr<IndexSpace> > IndexSpace::m_instance;
 AMREX_EXPORT int max_grid_size = 64;
 AMREX_EXPORT bool extend_domain_face = true;
 AMREX_EXPORT int num_coarsen_opt = 0;
+AMREX_EXPORT bool compact_cut_data = false;
 
 void Initialize ()
 {
@@ -30,6 +41,7 @@ void Initialize ()
     pp.queryAdd("max_grid_size", max_grid_size);
     pp.queryAdd("extend_domain_face", extend_domain_face);
     pp.queryAdd("num_coarsen_opt", num_coarsen_opt);
+    pp.queryAdd("compact_cut_data", compact_cut_data);
 
     amrex::ExecOnFinalize(Finalize);
 }
@@ -49,6 +61,11 @@ int NumCoarsenOpt ()
     return num_coarsen_opt;
 }
 
+bool CompactCutData ()
+{
+    return compact_cut_data;
+}
+
 void
 IndexSpace::push (IndexSpace* ispace)
 {
@@ -80,14 +97,38 @@ const IndexSpace* TopIndexSpaceIfPresent() noexcept {
     return nullptr;
 }
 
+namespace {
+// Add the defaults of the optional eb2.* inputs of a geometry type to
+// ParmParse, so that the cache key is the same before and after the
+// geometry is built.
 void
-Build (const Geometry& geom, int required_coarsening_level,
-       int max_coarsening_level, int ngrow, bool build_coarse_level_by_coarsening,
-       bool a_extend_domain_face, int a_num_coarsen_opt)
+add_default_inputs (ParmParse& pp, std::string const& geom_type)
+{
+    if (geom_type == "cylinder")
+    {
+        Real height = -1.0;
+        pp.queryAdd("cylinder_height", height);
+    }
+    else if (geom_type == "stl")
+    {
+        Real stl_scale = 1._rt;
+        pp.queryAdd("stl_scale", stl_scale);
+        std::vector<Real> stl_center{0.0_rt, 0.0_rt, 0.0_rt};
+        pp.queryAdd("stl_center", stl_center);
+        int stl_reverse_normal = 0;
+        pp.queryAdd("stl_reverse_normal", stl_reverse_normal);
+    }
+}
+
+void
+build_from_inputs (const Geometry& geom, int required_coarsening_level,
+                   int max_coarsening_level, int ngrow, bool build_coarse_level_by_coarsening,
+                   bool a_extend_domain_face, int a_num_coarsen_opt)
 {
     ParmParse pp("eb2");
     std::string geom_type;
     pp.get("geom_type", geom_type);
+    add_default_inputs(pp, geom_type);
 
     if (geom_type == "all_regular")
     {
@@ -123,8 +164,8 @@ Build (const Geometry& geom, int required_coarsening_level,
         Real radius;
         pp.get("cylinder_radius", radius);
 
-        Real height = -1.0;
-        pp.queryAdd("cylinder_height", height);
+        Real height;
+        pp.get("cylinder_height", height);
 
         int direction;
         pp.get("cylinder_direction", direction);
@@ -210,12 +251,12 @@ Build (const Geometry& geom, int required_coarsening_level,
     {
         std::string stl_file;
         pp.get("stl_file", stl_file);
-        Real stl_scale = 1._rt;
-        pp.queryAdd("stl_scale", stl_scale);
-        std::vector<Real> stl_center{0.0_rt, 0.0_rt, 0.0_rt};
-        pp.queryAdd("stl_center", stl_center);
-        int stl_reverse_normal = 0;
-        pp.queryAdd("stl_reverse_normal", stl_reverse_normal);
+        Real stl_scale;
+        pp.get("stl_scale", stl_scale);
+        std::vector<Real> stl_center;
+        pp.getarr("stl_center", stl_center);
+        int stl_reverse_normal;
+        pp.get("stl_reverse_normal", stl_reverse_normal);
         IndexSpace::push(new IndexSpaceSTL(stl_file, stl_scale, // NOLINT(clang-analyzer-cplusplus.NewDeleteLeaks)
                                            {stl_center[0], stl_center[1], stl_center[2]},
                                            stl_reverse_normal,
@@ -231,6 +272,180 @@ Build (const Geometry& geom, int required_coarsening_level,
     }
 }
 
+// 64-bit FNV-1a, so that the cache key does not depend on the compiler.
+void fnv1a (std::uint64_t& h, char const* p, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        h ^= static_cast<unsigned char>(p[i]);
+        h *= 0x100000001b3ULL;
+    }
+}
+
+void fnv1a (std::uint64_t& h, std::string const& s)
+{
+    fnv1a(h, s.data(), s.size()+1); // include the terminating null as a separator
+}
+
+// The eb2.* parameters that build_from_inputs reads for a geometry type
+std::vector<std::string>
+cache_key_params (std::string const& geom_type)
+{
+    std::vector<std::string> r{"geom_type"};
+    if (geom_type == "box") {
+        r.insert(r.end(), {"box_lo", "box_hi", "box_has_fluid_inside"});
+    } else if (geom_type == "cylinder") {
+        r.insert(r.end(), {"cylinder_center", "cylinder_radius", "cylinder_height",
+                           "cylinder_direction", "cylinder_has_fluid_inside"});
+    } else if (geom_type == "plane") {
+        r.insert(r.end(), {"plane_point", "plane_normal"});
+    } else if (geom_type == "sphere") {
+        r.insert(r.end(), {"sphere_center", "sphere_radius", "sphere_has_fluid_inside"});
+    } else if (geom_type == "torus") {
+        r.insert(r.end(), {"torus_center", "torus_small_radius", "torus_large_radius"});
+    } else if (geom_type == "parser") {
+        r.insert(r.end(), {"parser_function"});
+    } else if (geom_type == "stl") {
+        r.insert(r.end(), {"stl_file", "stl_scale", "stl_center", "stl_reverse_normal"});
+    }
+    return r;
+}
+
+// The key of the EB cache is a hash of the eb2.* inputs used by the
+// geometry, the content of the STL file if there is one, and the arguments
+// of Build.  Other eb2.* inputs are not queried, so that they are still
+// reported if they are unused.
+std::string
+cache_key (const Geometry& geom, int required_coarsening_level,
+           int max_coarsening_level, int ngrow, bool a_extend_domain_face)
+{
+    std::uint64_t h = 0xcbf29ce484222325ULL;
+
+    ParmParse pp("eb2");
+    std::string geom_type;
+    pp.get("geom_type", geom_type);
+    add_default_inputs(pp, geom_type);
+    for (auto const& name : cache_key_params(geom_type)) {
+        std::vector<std::string> vals;
+        pp.queryarr(name.c_str(), vals);
+        fnv1a(h, name);
+        for (auto const& v : vals) {
+            fnv1a(h, v);
+        }
+    }
+
+    if (geom_type == "stl") {
+        std::string stl_file;
+        pp.get("stl_file", stl_file);
+        Long hstl = 0;
+        if (ParallelDescriptor::IOProcessor()) {
+            std::ifstream is(stl_file, std::ios::in|std::ios::binary);
+            if (!is.good()) {
+                amrex::FileOpenFailed(stl_file);
+            }
+            std::uint64_t hs = 0xcbf29ce484222325ULL;
+            Vector<char> buf(VisMF::IO_Buffer_Size);
+            while (is) {
+                is.read(buf.data(), buf.size());
+                fnv1a(hs, buf.data(), static_cast<std::size_t>(is.gcount()));
+            }
+            std::memcpy(&hstl, &hs, sizeof(hs));
+        }
+        ParallelDescriptor::Bcast(&hstl, 1, ParallelDescriptor::IOProcessorNumber());
+        fnv1a(h, reinterpret_cast<char const*>(&hstl), sizeof(hstl));
+    }
+
+    std::ostringstream os;
+    os.precision(17);
+    os << AMREX_SPACEDIM << ' ' << sizeof(Real) << ' ' << geom.Domain() << ' ';
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        os << geom.ProbLo(idim) << ' ' << geom.ProbHi(idim) << ' ';
+    }
+    os << required_coarsening_level << ' ' << max_coarsening_level << ' ' << ngrow << ' '
+       << a_extend_domain_face << ' ' << EB2::max_grid_size << ' ';
+    // cut_boxes_per_proc only changes how the work is split, not the result.
+    const GShopInputs gshop_inputs;
+    os << gshop_inputs.small_volfrac << ' ' << gshop_inputs.cover_multiple_cuts << ' '
+       << gshop_inputs.maxiter;
+    fnv1a(h, os.str());
+
+    std::ostringstream key;
+    key << "eb2_" << std::hex << std::setw(16) << std::setfill('0') << h;
+    return key.str();
+}
+}
+
+void
+Build (const Geometry& geom, int required_coarsening_level,
+       int max_coarsening_level, int ngrow, bool build_coarse_level_by_coarsening,
+       bool a_extend_domain_face, int a_num_coarsen_opt)
+{
+    std::string cache_dir;
+    ParmParse("eb2").query("cache_dir", cache_dir);
+
+    // The cache only stores the finest level, and the coarse levels are
+    // rebuilt by coarsening.
+    if (cache_dir.empty() || !build_coarse_level_by_coarsening)
+    {
+        build_from_inputs(geom, required_coarsening_level, max_coarsening_level, ngrow,
+                          build_coarse_level_by_coarsening, a_extend_domain_face,
+                          a_num_coarsen_opt);
+        return;
+    }
+
+    const std::string cache_file = cache_dir + "/"
+        + cache_key(geom, required_coarsening_level, max_coarsening_level, ngrow,
+                    a_extend_domain_face);
+
+    // Only the I/O process checks, so that all processes take the same
+    // branch even if another run renames its cache into place meanwhile.
+    int has_cache = 0;
+    if (ParallelDescriptor::IOProcessor()) {
+        has_cache = static_cast<int>(amrex::FileExists(cache_file + "/Header"));
+    }
+    ParallelDescriptor::Bcast(&has_cache, 1, ParallelDescriptor::IOProcessorNumber());
+
+    if (has_cache)
+    {
+        if (amrex::Verbose()) {
+            amrex::Print() << "EB2::Build: reading " << cache_file << '\n';
+        }
+        BuildFromChkptFile(cache_file, geom, required_coarsening_level, max_coarsening_level,
+                           ngrow, build_coarse_level_by_coarsening, a_extend_domain_face);
+    }
+    else
+    {
+        build_from_inputs(geom, required_coarsening_level, max_coarsening_level, ngrow,
+                          build_coarse_level_by_coarsening, a_extend_domain_face,
+                          a_num_coarsen_opt);
+
+        if (amrex::Verbose()) {
+            amrex::Print() << "EB2::Build: writing " << cache_file << '\n';
+        }
+
+        // Write to a temporary name and rename it, so that other runs
+        // never see a partially written cache.
+        Long tag = 0;
+        if (ParallelDescriptor::IOProcessor()) {
+            tag = static_cast<Long>(std::random_device{}());
+        }
+        ParallelDescriptor::Bcast(&tag, 1, ParallelDescriptor::IOProcessorNumber());
+        const std::string tmp_file = cache_file + ".temp" + std::to_string(tag);
+
+        IndexSpace::top().getLevel(geom).write_to_chkpt_file(tmp_file, a_extend_domain_face,
+                                                             EB2::max_grid_size);
+        ParallelDescriptor::Barrier();
+        if (ParallelDescriptor::IOProcessor()) {
+            if (amrex::FileExists(cache_file + "/Header") ||
+                std::rename(tmp_file.c_str(), cache_file.c_str()) != 0)
+            {
+                // Another run got there first.
+                FileSystem::RemoveAll(tmp_file);
+            }
+        }
+        ParallelDescriptor::Barrier();
+    }
+}
+
 void addFineLevels (int num_new_fine_levels)
 {
     BL_PROFILE("EB2::addFineLevels()");
@@ -3,7 +3,9 @@
 #include <AMReX_MultiFab.H>
 #include <AMReX_iMultiFab.H>
 #include <AMReX_MultiCutFab.H>
+#include <AMReX_MultiSparseCutFab.H>
 
+#include <AMReX_EB2.H>
 #include <AMReX_EB2_Level.H>
 #include <algorithm>
 #include <utility>
@@ -81,6 +83,40 @@ EBDataCollection::EBDataCollection (const EB2::Level& a_level,
     if (! a_level.isAllRegular()) {
         extendDataOutsideDomain(a_level.nGrowVect());
     }
+
+    m_compact = EB2::CompactCutData() && m_support >= EBSupport::volume;
+    if (m_compact)
+    {
+        makeSparse(m_sparse_volfrac, m_volfrac, 1._rt, 0._rt);
+        makeSparse(m_sparse_centroid, m_centroid, 0._rt, 0._rt);
+        delete m_volfrac;
+        delete m_centroid;
+        m_volfrac = nullptr;
+        m_centroid = nullptr;
+        if (m_support == EBSupport::full)
+        {
+            makeSparse(m_sparse_bndrycent, m_bndrycent, -1._rt, -1._rt);
+            makeSparse(m_sparse_bndryarea, m_bndryarea, 0._rt, 0._rt);
+            makeSparse(m_sparse_bndrynorm, m_bndrynorm, 0._rt, 0._rt);
+            delete m_bndrycent;
+            delete m_bndryarea;
+            delete m_bndrynorm;
+            m_bndrycent = nullptr;
+            m_bndryarea = nullptr;
+            m_bndrynorm = nullptr;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                makeSparse(m_sparse_areafrac[idim], m_areafrac[idim], 1._rt, 0._rt);
+                makeSparse(m_sparse_facecent[idim], m_facecent[idim], 0._rt, 0._rt);
+                makeSparse(m_sparse_edgecent[idim], m_edgecent[idim], 1._rt, -1._rt);
+                delete m_areafrac[idim];
+                delete m_facecent[idim];
+                delete m_edgecent[idim];
+                m_areafrac[idim] = nullptr;
+                m_facecent[idim] = nullptr;
+                m_edgecent[idim] = nullptr;
+            }
+        }
+    }
 }
 
 void EBDataCollection::extendDataOutsideDomain (IntVect const& level_ng)
@@ -248,6 +284,16 @@ EBDataCollection::~EBDataCollection ()
         delete m_edgecent[idim];
     }
     delete m_cutcellmask;
+    delete m_sparse_volfrac;
+    delete m_sparse_centroid;
+    delete m_sparse_bndrycent;
+    delete m_sparse_bndryarea;
+    delete m_sparse_bndrynorm;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        delete m_sparse_areafrac[idim];
+        delete m_sparse_facecent[idim];
+        delete m_sparse_edgecent[idim];
+    }
 }
 
 const FabArray<EBCellFlagFab>&
@@ -267,6 +313,7 @@ EBDataCollection::getLevelSet () const
 const MultiFab&
 EBDataCollection::getVolFrac () const
 {
+    if (m_compact) { makeDense(m_volfrac, m_sparse_volfrac); }
     AMREX_ASSERT(m_volfrac != nullptr);
     return *m_volfrac;
 }
@@ -274,6 +321,7 @@ EBDataCollection::getVolFrac () const
 const MultiCutFab&
 EBDataCollection::getCentroid () const
 {
+    if (m_compact) { makeDense(m_centroid, m_sparse_centroid); }
     AMREX_ASSERT(m_centroid != nullptr);
     return *m_centroid;
 }
@@ -281,6 +329,7 @@ EBDataCollection::getCentroid () const
 const MultiCutFab&
 EBDataCollection::getBndryCent () const
 {
+    if (m_compact) { makeDense(m_bndrycent, m_sparse_bndrycent); }
     AMREX_ASSERT(m_bndrycent != nullptr);
     return *m_bndrycent;
 }
@@ -288,6 +337,7 @@ EBDataCollection::getBndryCent () const
 const MultiCutFab&
 EBDataCollection::getBndryArea () const
 {
+    if (m_compact) { makeDense(m_bndryarea, m_sparse_bndryarea); }
     AMREX_ASSERT(m_bndryarea != nullptr);
     return *m_bndryarea;
 }
@@ -295,6 +345,11 @@ EBDataCollection::getBndryArea () const
 Array<const MultiCutFab*, AMREX_SPACEDIM>
 EBDataCollection::getAreaFrac () const
 {
+    if (m_compact) {
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            makeDense(m_areafrac[idim], m_sparse_areafrac[idim]);
+        }
+    }
     AMREX_ASSERT(m_areafrac[0] != nullptr);
     return {AMREX_D_DECL(m_areafrac[0], m_areafrac[1], m_areafrac[2])};
 }
@@ -302,6 +357,11 @@ EBDataCollection::getAreaFrac () const
 Array<const MultiCutFab*, AMREX_SPACEDIM>
 EBDataCollection::getFaceCent () const
 {
+    if (m_compact) {
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            makeDense(m_facecent[idim], m_sparse_facecent[idim]);
+        }
+    }
     AMREX_ASSERT(m_facecent[0] != nullptr);
     return {AMREX_D_DECL(m_facecent[0], m_facecent[1], m_facecent[2])};
 }
@@ -309,6 +369,11 @@ EBDataCollection::getFaceCent () const
 Array<const MultiCutFab*, AMREX_SPACEDIM>
 EBDataCollection::getEdgeCent () const
 {
+    if (m_compact) {
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            makeDense(m_edgecent[idim], m_sparse_edgecent[idim]);
+        }
+    }
     AMREX_ASSERT(m_edgecent[0] != nullptr);
     return {AMREX_D_DECL(m_edgecent[0], m_edgecent[1], m_edgecent[2])};
 }
@@ -316,6 +381,7 @@ EBDataCollection::getEdgeCent () const
 const MultiCutFab&
 EBDataCollection::getBndryNormal () const
 {
+    if (m_compact) { makeDense(m_bndrynorm, m_sparse_bndrynorm); }
     AMREX_ASSERT(m_bndrynorm != nullptr);
     return *m_bndrynorm;
 }
@@ -326,4 +392,146 @@ EBDataCollection::getCutCellMask () const
     return m_cutcellmask;
 }
 
+
+const MultiSparseCutFab&
+EBDataCollection::getSparseVolFrac () const
+{
+    if (!m_compact) { makeSparse(m_sparse_volfrac, m_volfrac, 1._rt, 0._rt); }
+    AMREX_ASSERT(m_sparse_volfrac != nullptr);
+    return *m_sparse_volfrac;
+}
+
+const MultiSparseCutFab&
+EBDataCollection::getSparseCentroid () const
+{
+    if (!m_compact) { makeSparse(m_sparse_centroid, m_centroid, 0._rt, 0._rt); }
+    AMREX_ASSERT(m_sparse_centroid != nullptr);
+    return *m_sparse_centroid;
+}
+
+const MultiSparseCutFab&
+EBDataCollection::getSparseBndryCent () const
+{
+    if (!m_compact) { makeSparse(m_sparse_bndrycent, m_bndrycent, -1._rt, -1._rt); }
+    AMREX_ASSERT(m_sparse_bndrycent != nullptr);
+    return *m_sparse_bndrycent;
+}
+
+const MultiSparseCutFab&
+EBDataCollection::getSparseBndryArea () const
+{
+    if (!m_compact) { makeSparse(m_sparse_bndryarea, m_bndryarea, 0._rt, 0._rt); }
+    AMREX_ASSERT(m_sparse_bndryarea != nullptr);
+    return *m_sparse_bndryarea;
+}
+
+const MultiSparseCutFab&
+EBDataCollection::getSparseBndryNormal () const
+{
+    if (!m_compact) { makeSparse(m_sparse_bndrynorm, m_bndrynorm, 0._rt, 0._rt); }
+    AMREX_ASSERT(m_sparse_bndrynorm != nullptr);
+    return *m_sparse_bndrynorm;
+}
+
+Array<const MultiSparseCutFab*, AMREX_SPACEDIM>
+EBDataCollection::getSparseAreaFrac () const
+{
+    if (!m_compact) {
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            makeSparse(m_sparse_areafrac[idim], m_areafrac[idim], 1._rt, 0._rt);
+        }
+    }
+    AMREX_ASSERT(m_sparse_areafrac[0] != nullptr);
+    return {AMREX_D_DECL(m_sparse_areafrac[0], m_sparse_areafrac[1], m_sparse_areafrac[2])};
+}
+
+Array<const MultiSparseCutFab*, AMREX_SPACEDIM>
+EBDataCollection::getSparseFaceCent () const
+{
+    if (!m_compact) {
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            makeSparse(m_sparse_facecent[idim], m_facecent[idim], 0._rt, 0._rt);
+        }
+    }
+    AMREX_ASSERT(m_sparse_facecent[0] != nullptr);
+    return {AMREX_D_DECL(m_sparse_facecent[0], m_sparse_facecent[1], m_sparse_facecent[2])};
+}
+
+Array<const MultiSparseCutFab*, AMREX_SPACEDIM>
+EBDataCollection::getSparseEdgeCent () const
+{
+    if (!m_compact) {
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            makeSparse(m_sparse_edgecent[idim], m_edgecent[idim], 1._rt, -1._rt);
+        }
+    }
+    AMREX_ASSERT(m_sparse_edgecent[0] != nullptr);
+    return {AMREX_D_DECL(m_sparse_edgecent[0], m_sparse_edgecent[1], m_sparse_edgecent[2])};
+}
+
+void
+EBDataCollection::releaseDenseData () const
+{
+    if (!m_compact) { return; }
+    AMREX_ALWAYS_ASSERT(!OpenMP::in_parallel());
+    delete m_volfrac;
+    delete m_centroid;
+    delete m_bndrycent;
+    delete m_bndryarea;
+    delete m_bndrynorm;
+    m_volfrac = nullptr;
+    m_centroid = nullptr;
+    m_bndrycent = nullptr;
+    m_bndryarea = nullptr;
+    m_bndrynorm = nullptr;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        delete m_areafrac[idim];
+        delete m_facecent[idim];
+        delete m_edgecent[idim];
+        m_areafrac[idim] = nullptr;
+        m_facecent[idim] = nullptr;
+        m_edgecent[idim] = nullptr;
+    }
+}
+
+void
+EBDataCollection::makeSparse (MultiSparseCutFab*& sparse, const MultiFab* dense,
+                              Real regular_value, Real covered_value) const
+{
+    if (sparse == nullptr && dense != nullptr) {
+        AMREX_ALWAYS_ASSERT(!OpenMP::in_parallel());
+        sparse = new MultiSparseCutFab(*dense, *m_cellflags, regular_value, covered_value);
+    }
+}
+
+void
+EBDataCollection::makeSparse (MultiSparseCutFab*& sparse, const MultiCutFab* dense,
+                              Real regular_value, Real covered_value) const
+{
+    if (sparse == nullptr && dense != nullptr) {
+        AMREX_ALWAYS_ASSERT(!OpenMP::in_parallel());
+        sparse = new MultiSparseCutFab(*dense, *m_cellflags, regular_value, covered_value);
+    }
+}
+
+void
+EBDataCollection::makeDense (MultiFab*& dense, const MultiSparseCutFab* sparse) const
+{
+    if (dense == nullptr && sparse != nullptr) {
+        AMREX_ALWAYS_ASSERT(!OpenMP::in_parallel());
+        dense = new MultiFab(sparse->ToMultiFab());
+    }
+}
+
+void
+EBDataCollection::makeDense (MultiCutFab*& dense, const MultiSparseCutFab* sparse) const
+{
+    if (dense == nullptr && sparse != nullptr) {
+        AMREX_ALWAYS_ASSERT(!OpenMP::in_parallel());
+        dense = new MultiCutFab(sparse->boxArray(), sparse->DistributionMap(),
+                                sparse->nComp(), sparse->nGrow(), *m_cellflags);
+        sparse->copyTo(*dense);
+    }
+}
+
 }
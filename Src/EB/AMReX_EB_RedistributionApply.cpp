@@ -10,6 +10,104 @@
 
 namespace amrex {
 
+namespace {
+
+// Everything StateRedist does after the geometric data have been computed
+void apply_state_redistribution ( Box const& bx, int ncomp,
+                                  Array4<Real      > const& dUdt_out,
+                                  Array4<Real      > const& dUdt_in,
+                                  Array4<Real const> const& U_in,
+                                  Array4<Real      > const& scratch,
+                                  Array4<EBCellFlag const> const& flag,
+                                  Array4<Real const> const& vfrac,
+                                  AMREX_D_DECL(Array4<Real const> const& fcx,
+                                               Array4<Real const> const& fcy,
+                                               Array4<Real const> const& fcz),
+                                  Array4<Real const> const& ccc,
+                                  amrex::BCRec  const* d_bcrec_ptr,
+                                  Geometry const& lev_geom, Real dt,
+                                  Array4<int  const> const& itr,
+                                  Array4<Real const> const& nrs,
+                                  Array4<Real const> const& alpha,
+                                  Array4<Real const> const& nbhd_vol,
+                                  Array4<Real const> const& cent_hat,
+                                  int as_crse,
+                                  Array4<Real            > const& rr_drho_crse,
+                                  Array4<int        const> const& rr_flag_crse,
+                                  int as_fine,
+                                  Array4<Real            > const& dm_as_fine,
+                                  Array4<int        const> const& levmsk,
+                                  int level_mask_not_covered,
+                                  Real fac_for_deltaR,
+                                  int srd_max_order,
+                                  Array4<Real const> const& srd_update_scale)
+{
+    Box const& bxg1 = grow(bx,1);
+
+    Box domain_per_grown = lev_geom.Domain();
+    AMREX_D_TERM(if (lev_geom.isPeriodic(0)) { domain_per_grown.grow(0,1); },
+                 if (lev_geom.isPeriodic(1)) { domain_per_grown.grow(1,1); },
+                 if (lev_geom.isPeriodic(2)) { domain_per_grown.grow(2,1); })
+
+    // At any external Dirichlet domain boundaries we need to set dUdt_in to 0
+    //    in the cells just outside the domain because those values will be used
+    //    in the slope computation in state redistribution.  We assume here that
+    //    the ext_dir values of U_in itself have already been set.
+    if (!domain_per_grown.contains(bxg1)) {
+        amrex::ParallelFor(bxg1,ncomp,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                if (!domain_per_grown.contains(IntVect(AMREX_D_DECL(i,j,k)))) {
+                    dUdt_in(i,j,k,n) = 0.;
+                }
+            });
+    }
+
+    amrex::ParallelFor(Box(scratch), ncomp,
+    [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            const Real scale = (srd_update_scale) ? srd_update_scale(i,j,k) : Real(1.0);
+            scratch(i,j,k,n) = U_in(i,j,k,n) + dt * dUdt_in(i,j,k,n) / scale;
+        }
+    );
+
+    MLStateRedistribute(bx, ncomp, dUdt_out, scratch, flag, vfrac,
+                        AMREX_D_DECL(fcx, fcy, fcz), ccc,  d_bcrec_ptr,
+                        itr, nrs, alpha, nbhd_vol,
+                        cent_hat, lev_geom,
+                        as_crse, rr_drho_crse, rr_flag_crse,
+                        as_fine, dm_as_fine, levmsk,
+                        level_mask_not_covered, fac_for_deltaR, srd_max_order);
+
+    amrex::ParallelFor(bx, ncomp,
+    [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            // Only update the values which actually changed -- this makes
+            // the results insensitive to tiling -- otherwise cells that aren't
+            // changed but are in a tile on which StateRedistribute gets called
+            // will have precision-level changes due to adding/subtracting U_in
+            // and multiplying/dividing by dt.   Here we test on whether (i,j,k)
+            // has at least one neighbor and/or whether (i,j,k) is in the
+            // neighborhood of another cell -- if either of those is true the
+            // value may have changed
+
+            if (itr(i,j,k,0) > 0 || nrs(i,j,k) > 1.)
+            {
+               const Real scale = (srd_update_scale) ? srd_update_scale(i,j,k) : Real(1.0);
+
+               dUdt_out(i,j,k,n) = scale * (dUdt_out(i,j,k,n) - U_in(i,j,k,n)) / dt;
+
+            }
+            else
+            {
+               dUdt_out(i,j,k,n) = dUdt_in(i,j,k,n);
+            }
+        }
+    );
+}
+
+}
+
 void ApplyRedistribution ( Box const& bx, int ncomp,
                            Array4<Real      > const& dUdt_out,
                            Array4<Real      > const& dUdt_in,
@@ -52,6 +150,51 @@ void ApplyRedistribution ( Box const& bx, int ncomp,
                            srd_max_order, target_volfrac, srd_update_scale);
 }
 
+void ApplyRedistribution ( Box const& bx, int ncomp,
+                           Array4<Real      > const& dUdt_out,
+                           Array4<Real      > const& dUdt_in,
+                           Array4<Real const> const& U_in,
+                           Array4<Real> const& scratch,
+                           Array4<EBCellFlag const> const& flag,
+                           Array4<amrex::Real const> const& vfrac,
+                           AMREX_D_DECL(Array4<Real const> const& fcx,
+                                        Array4<Real const> const& fcy,
+                                        Array4<Real const> const& fcz),
+                           Array4<Real const> const& ccc,
+                           amrex::BCRec  const* d_bcrec_ptr,
+                           Geometry const& lev_geom, Real dt,
+                           StateRedistPlan::BoxData const& plan,
+                           int srd_max_order,
+                           Array4<Real const> const& srd_update_scale)
+{
+    // The plan has no data for boxes without cut cells, even in the ghost
+    //    cells of the factory, so none of their cells are merged.
+    if (plan.box.isEmpty()) {
+        amrex::ParallelFor(bx,ncomp,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                dUdt_out(i,j,k,n) = dUdt_in(i,j,k,n);
+            });
+        return;
+    }
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(plan.box == bx,
+        "ApplyRedistribution: the StateRedistPlan was not built for this box");
+
+    amrex::ParallelFor(bx,ncomp,
+    [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            dUdt_out(i,j,k,n) = 0.;
+        });
+
+    apply_state_redistribution(bx, ncomp, dUdt_out, dUdt_in, U_in, scratch, flag, vfrac,
+                               AMREX_D_DECL(fcx, fcy, fcz), ccc, d_bcrec_ptr, lev_geom, dt,
+                               plan.itracker, plan.nrs, plan.alpha, plan.nbhd_vol, plan.cent_hat,
+                               0, Array4<Real>(), Array4<int const>(),
+                               0, Array4<Real>(), Array4<int const>(),
+                               -1, 1.0_rt, srd_max_order, srd_update_scale);
+}
+
 void
 ApplyMLRedistribution ( Box const& bx, int ncomp,
                         Array4<Real      > const& dUdt_out,
@@ -107,7 +250,6 @@ ApplyMLRedistribution ( Box const& bx, int ncomp,
 
     } else if (redistribution_type == "StateRedist") {
 
-        Box const& bxg1 = grow(bx,1);
         Box const& bxg3 = grow(bx,3);
         Box const& bxg4 = grow(bx,4);
         Box const& bxg5 = grow(bx,5);
@@ -149,71 +291,18 @@ ApplyMLRedistribution ( Box const& bx, int ncomp,
         Array4<Real      > cent_hat       = cent_hat_fab.array();
         Array4<Real const> cent_hat_const = cent_hat_fab.const_array();
 
-        Box domain_per_grown = lev_geom.Domain();
-        AMREX_D_TERM(if (lev_geom.isPeriodic(0)) { domain_per_grown.grow(0,1); },
-                     if (lev_geom.isPeriodic(1)) { domain_per_grown.grow(1,1); },
-                     if (lev_geom.isPeriodic(2)) { domain_per_grown.grow(2,1); })
-
-        // At any external Dirichlet domain boundaries we need to set dUdt_in to 0
-        //    in the cells just outside the domain because those values will be used
-        //    in the slope computation in state redistribution.  We assume here that
-        //    the ext_dir values of U_in itself have already been set.
-        if (!domain_per_grown.contains(bxg1)) {
-            amrex::ParallelFor(bxg1,ncomp,
-            [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
-                {
-                    if (!domain_per_grown.contains(IntVect(AMREX_D_DECL(i,j,k)))) {
-                        dUdt_in(i,j,k,n) = 0.;
-                    }
-                });
-        }
-
-        amrex::ParallelFor(Box(scratch), ncomp,
-        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
-            {
-                const Real scale = (srd_update_scale) ? srd_update_scale(i,j,k) : Real(1.0);
-                scratch(i,j,k,n) = U_in(i,j,k,n) + dt * dUdt_in(i,j,k,n) / scale;
-            }
-        );
-
         MakeITracker(bx, AMREX_D_DECL(apx, apy, apz), vfrac, itr, lev_geom, target_volfrac);
 
         MakeStateRedistUtils(bx, flag, vfrac, ccc, itr, nrs, alpha, nbhd_vol, cent_hat,
                              lev_geom, target_volfrac);
 
-        MLStateRedistribute(bx, ncomp, dUdt_out, scratch, flag, vfrac,
-                            AMREX_D_DECL(fcx, fcy, fcz), ccc,  d_bcrec_ptr,
-                            itr_const, nrs_const, alpha_const, nbhd_vol_const,
-                            cent_hat_const, lev_geom,
-                            as_crse, rr_drho_crse, rr_flag_crse,
-                            as_fine, dm_as_fine, levmsk,
-                            level_mask_not_covered, fac_for_deltaR, srd_max_order);
-
-        amrex::ParallelFor(bx, ncomp,
-        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
-            {
-                // Only update the values which actually changed -- this makes
-                // the results insensitive to tiling -- otherwise cells that aren't
-                // changed but are in a tile on which StateRedistribute gets called
-                // will have precision-level changes due to adding/subtracting U_in
-                // and multiplying/dividing by dt.   Here we test on whether (i,j,k)
-                // has at least one neighbor and/or whether (i,j,k) is in the
-                // neighborhood of another cell -- if either of those is true the
-                // value may have changed
-
-                if (itr(i,j,k,0) > 0 || nrs(i,j,k) > 1.)
-                {
-                   const Real scale = (srd_update_scale) ? srd_update_scale(i,j,k) : Real(1.0);
-
-                   dUdt_out(i,j,k,n) = scale * (dUdt_out(i,j,k,n) - U_in(i,j,k,n)) / dt;
-
-                }
-                else
-                {
-                   dUdt_out(i,j,k,n) = dUdt_in(i,j,k,n);
-                }
-            }
-        );
+        apply_state_redistribution(bx, ncomp, dUdt_out, dUdt_in, U_in, scratch, flag, vfrac,
+                                   AMREX_D_DECL(fcx, fcy, fcz), ccc, d_bcrec_ptr, lev_geom, dt,
+                                   itr_const, nrs_const, alpha_const, nbhd_vol_const, cent_hat_const,
+                                   as_crse, rr_drho_crse, rr_flag_crse,
+                                   as_fine, dm_as_fine, levmsk,
+                                   level_mask_not_covered, fac_for_deltaR, srd_max_order,
+                                   srd_update_scale);
 
     } else if (redistribution_type == "NoRedist") {
         amrex::ParallelFor(bx, ncomp,
@@ -312,4 +401,81 @@ ApplyInitialRedistribution ( Box const& bx, int ncomp,
                       cent_hat_const, lev_geom, srd_max_order);
 }
 
+StateRedistPlan::StateRedistPlan (EBFArrayBoxFactory const& factory,
+                                  Geometry const& lev_geom, Real target_volfrac)
+{
+    define(factory, lev_geom, target_volfrac);
+}
+
+void
+StateRedistPlan::define (EBFArrayBoxFactory const& factory,
+                         Geometry const& lev_geom, Real target_volfrac)
+{
+    BL_PROFILE("StateRedistPlan::define()");
+
+    m_ba = factory.boxArray();
+    m_dm = factory.DistributionMap();
+    m_target_volfrac = target_volfrac;
+
+    m_itracker.define(m_ba, m_dm);
+    m_nrs.define(m_ba, m_dm);
+    m_alpha.define(m_ba, m_dm);
+    m_nbhd_vol.define(m_ba, m_dm);
+    m_cent_hat.define(m_ba, m_dm);
+
+    auto const& flags = factory.getMultiEBCellFlagFab();
+    auto const& vfrac = factory.getVolFrac();
+    auto const& ccent = factory.getCentroid();
+    auto const& area  = factory.getAreaFrac();
+
+    // These are the same sizes as the temporaries ApplyMLRedistribution
+    //    allocates for every call.
+#if (AMREX_SPACEDIM == 2)
+    constexpr int nitracker = 4;
+#else
+    constexpr int nitracker = 8;
+#endif
+
+    for (MFIter mfi(flags); mfi.isValid(); ++mfi)
+    {
+        if (flags[mfi].getType() != FabType::singlevalued) { continue; }
+
+        Box const& bx = mfi.validbox();
+        m_itracker[mfi].resize(amrex::grow(bx,5), nitracker);
+        m_nrs     [mfi].resize(amrex::grow(bx,5), 1);
+        m_alpha   [mfi].resize(amrex::grow(bx,4), 2);
+        m_nbhd_vol[mfi].resize(amrex::grow(bx,3), 1);
+        m_cent_hat[mfi].resize(amrex::grow(bx,3), AMREX_SPACEDIM);
+
+        MakeITracker(bx, AMREX_D_DECL(area[0]->const_array(mfi),
+                                      area[1]->const_array(mfi),
+                                      area[2]->const_array(mfi)),
+                     vfrac.const_array(mfi), m_itracker[mfi].array(), lev_geom, target_volfrac);
+
+        MakeStateRedistUtils(bx, flags.const_array(mfi), vfrac.const_array(mfi),
+                             ccent.const_array(mfi), m_itracker[mfi].const_array(),
+                             m_nrs[mfi].array(), m_alpha[mfi].array(),
+                             m_nbhd_vol[mfi].array(), m_cent_hat[mfi].array(),
+                             lev_geom, target_volfrac);
+    }
+
+    Gpu::streamSynchronize();
+}
+
+StateRedistPlan::BoxData
+StateRedistPlan::const_arrays (MFIter const& mfi) const noexcept
+{
+    BoxData r;
+    auto const& itracker = m_itracker[mfi];
+    if (itracker.box().ok()) {
+        r.box = amrex::grow(itracker.box(), -5);
+        r.itracker = itracker.const_array();
+        r.nrs      = m_nrs     [mfi].const_array();
+        r.alpha    = m_alpha   [mfi].const_array();
+        r.nbhd_vol = m_nbhd_vol[mfi].const_array();
+        r.cent_hat = m_cent_hat[mfi].const_array();
+    }
+    return r;
+}
+
 }
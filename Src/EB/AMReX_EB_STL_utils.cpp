@@ -1,7 +1,10 @@
 #include <AMReX_EB_STL_utils.H>
 #include <AMReX_EB_triGeomOps_K.H>
 #include <AMReX_IntConv.H>
+#include <AMReX_Math.H>
+#include <algorithm>
 #include <cstring>
+#include <numeric>
 
 namespace amrex
 {
@@ -89,6 +92,218 @@ namespace {
             return std::make_pair(false,0.0_rt);
         }
     }
+
+    // Does line ab intersect with the box of a BVH node?  This is a slab
+    // test.  It only needs to be conservative, because the node boxes are
+    // padded and the triangles are tested exactly afterwards.
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    bool line_box_intersects (Real const a[3], Real const b[3], STLtools::BVHNode const& node)
+    {
+        Real const lo[] = {node.lo.x, node.lo.y, node.lo.z};
+        Real const hi[] = {node.hi.x, node.hi.y, node.hi.z};
+        Real tmin = 0._rt;
+        Real tmax = 1._rt;
+        for (int d = 0; d < 3; ++d) {
+            Real dir = b[d] - a[d];
+            if (dir == 0._rt) {
+                if (a[d] < lo[d] || a[d] > hi[d]) { return false; }
+            } else {
+                Real t1 = (lo[d] - a[d]) / dir;
+                Real t2 = (hi[d] - a[d]) / dir;
+                if (t1 > t2) { amrex::Swap(t1,t2); }
+                tmin = amrex::max(tmin, t1);
+                tmax = amrex::min(tmax, t2);
+                if (tmin > tmax) { return false; }
+            }
+        }
+        return true;
+    }
+
+    // Does line (x1,y,z)->(x2,y,z) intersect with the box of a BVH node?
+    // The coordinates are permuted in the same way as edge_tri_intersects.
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    bool edge_box_intersects (Real x1, Real x2, Real y, Real z,
+                              XDim3 const& lo, XDim3 const& hi)
+    {
+        return !(x1 > hi.x || x2 < lo.x || y > hi.y || y < lo.y || z > hi.z || z < lo.z);
+    }
+
+    // Visit the triangles in the leaves of all BVH nodes that pass node_test.
+    template <typename NT, typename TF>
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    void bvh_for_each (STLtools::BVHNode const* nodes, int const* tri_index,
+                       NT const& node_test, TF const& tri_func)
+    {
+        int stack[STLtools::bvh_max_depth];
+        int sp = 0;
+        stack[sp++] = 0;
+        while (sp > 0) {
+            auto const& node = nodes[stack[--sp]];
+            if (node_test(node)) {
+                if (node.count > 0) {
+                    for (int n = node.first; n < node.first+node.count; ++n) {
+                        tri_func(tri_index[n]);
+                    }
+                } else {
+                    stack[sp++] = node.first+1;
+                    stack[sp++] = node.first;
+                }
+            }
+        }
+    }
+
+    // Number of triangles intersected by line ab
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    int num_line_intersects (Real a[3], Real b[3], STLtools::Triangle const* tri_pts,
+                             STLtools::BVHNode const* bvh_nodes, int const* bvh_tri_index)
+    {
+        int num_intersects = 0;
+        bvh_for_each(bvh_nodes, bvh_tri_index,
+                     [&] (STLtools::BVHNode const& node) {
+                         return line_box_intersects(a, b, node);
+                     },
+                     [&] (int tr) {
+                         if (line_tri_intersects(a, b, tri_pts[tr])) {
+                             ++num_intersects;
+                         }
+                     });
+        return num_intersects;
+    }
+
+    // Squared distance between point p and the box of a BVH node
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    Real point_box_dist2 (Real const p[3], STLtools::BVHNode const& node)
+    {
+        Real dx = amrex::max(node.lo.x-p[0], 0._rt, p[0]-node.hi.x);
+        Real dy = amrex::max(node.lo.y-p[1], 0._rt, p[1]-node.hi.y);
+        Real dz = amrex::max(node.lo.z-p[2], 0._rt, p[2]-node.hi.z);
+        return dx*dx + dy*dy + dz*dz;
+    }
+
+    // Squared distance between point p and the closest point on the
+    // triangle.  See Ericson, Real-Time Collision Detection, Sec. 5.1.5.
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    Real point_tri_dist2 (Real const p[3], STLtools::Triangle const& tri)
+    {
+        Real const a[] = {tri.v1.x, tri.v1.y, tri.v1.z};
+        Real const b[] = {tri.v2.x, tri.v2.y, tri.v2.z};
+        Real const c[] = {tri.v3.x, tri.v3.y, tri.v3.z};
+        Real ab[3], ac[3], ap[3], bp[3], cp[3];
+        for (int d = 0; d < 3; ++d) {
+            ab[d] = b[d] - a[d];
+            ac[d] = c[d] - a[d];
+            ap[d] = p[d] - a[d];
+            bp[d] = p[d] - b[d];
+            cp[d] = p[d] - c[d];
+        }
+        auto dot = [] (Real const u[3], Real const v[3]) {
+            return u[0]*v[0] + u[1]*v[1] + u[2]*v[2];
+        };
+        auto dist2 = [&] (Real const o[3], Real const e[3], Real t) {
+            Real r = 0._rt;
+            for (int d = 0; d < 3; ++d) {
+                Real q = p[d] - (o[d] + t*e[d]);
+                r += q*q;
+            }
+            return r;
+        };
+
+        Real d1 = dot(ab,ap);
+        Real d2 = dot(ac,ap);
+        if (d1 <= 0._rt && d2 <= 0._rt) { return dot(ap,ap); }
+
+        Real d3 = dot(ab,bp);
+        Real d4 = dot(ac,bp);
+        if (d3 >= 0._rt && d4 <= d3) { return dot(bp,bp); }
+
+        Real vc = d1*d4 - d3*d2;
+        if (vc <= 0._rt && d1 >= 0._rt && d3 <= 0._rt) {
+            return dist2(a, ab, d1/(d1-d3));
+        }
+
+        Real d5 = dot(ab,cp);
+        Real d6 = dot(ac,cp);
+        if (d6 >= 0._rt && d5 <= d6) { return dot(cp,cp); }
+
+        Real vb = d5*d2 - d1*d6;
+        if (vb <= 0._rt && d2 >= 0._rt && d6 <= 0._rt) {
+            return dist2(a, ac, d2/(d2-d6));
+        }
+
+        Real va = d3*d6 - d5*d4;
+        if (va <= 0._rt && (d4-d3) >= 0._rt && (d5-d6) >= 0._rt) {
+            Real const bc[] = {c[0]-b[0], c[1]-b[1], c[2]-b[2]};
+            return dist2(b, bc, (d4-d3)/((d4-d3)+(d5-d6)));
+        }
+
+        // p projects onto the interior of the triangle
+        Real denom = va + vb + vc;
+        if (denom <= 0._rt) { // degenerate triangle
+            return amrex::min(dot(ap,ap), dot(bp,bp), dot(cp,cp));
+        }
+        Real v = vb / denom;
+        Real w = vc / denom;
+        Real r = 0._rt;
+        for (int d = 0; d < 3; ++d) {
+            Real q = ap[d] - (v*ab[d] + w*ac[d]);
+            r += q*q;
+        }
+        return r;
+    }
+
+    // Solid angle of the triangle seen from p divided by 4 pi.  It is
+    // positive if the triangle's normal points away from p.  See Van
+    // Oosterom and Strackee, IEEE Trans. Biomed. Eng. 30 (1983).
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    Real tri_winding_number (Real const p[3], STLtools::Triangle const& tri)
+    {
+        Real const a[] = {tri.v1.x-p[0], tri.v1.y-p[1], tri.v1.z-p[2]};
+        Real const b[] = {tri.v2.x-p[0], tri.v2.y-p[1], tri.v2.z-p[2]};
+        Real const c[] = {tri.v3.x-p[0], tri.v3.y-p[1], tri.v3.z-p[2]};
+        auto dot = [] (Real const u[3], Real const v[3]) {
+            return u[0]*v[0] + u[1]*v[1] + u[2]*v[2];
+        };
+        Real la = std::sqrt(dot(a,a));
+        Real lb = std::sqrt(dot(b,b));
+        Real lc = std::sqrt(dot(c,c));
+        Real det = a[0]*(b[1]*c[2]-b[2]*c[1])
+            +      a[1]*(b[2]*c[0]-b[0]*c[2])
+            +      a[2]*(b[0]*c[1]-b[1]*c[0]);
+        Real den = la*lb*lc + dot(a,b)*lc + dot(b,c)*la + dot(c,a)*lb;
+        return std::atan2(det,den) * (Real(0.5)/Math::pi<Real>());
+    }
+
+    // Generalized winding number of the surface at p.  For a closed
+    // surface it is 1 on the side the normals point away from and 0 on the
+    // other side.  Nodes whose triangles are all within 1/beta of their
+    // distance to p are replaced by the dipole term of their moments.
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    Real winding_number (Real const p[3], STLtools::Triangle const* tri_pts,
+                         STLtools::BVHNode const* bvh_nodes,
+                         STLtools::BVHMoment const* bvh_moments, int const* bvh_tri_index)
+    {
+        constexpr Real beta = 2._rt;
+        Real w = 0._rt;
+        bvh_for_each(bvh_nodes, bvh_tri_index,
+                     [&] (STLtools::BVHNode const& node) {
+                         auto const& m = bvh_moments[&node - bvh_nodes];
+                         Real rx = m.center.x - p[0];
+                         Real ry = m.center.y - p[1];
+                         Real rz = m.center.z - p[2];
+                         Real r2 = rx*rx + ry*ry + rz*rz;
+                         if (r2 > beta*beta*m.radius*m.radius) {
+                             w += (rx*m.normal.x + ry*m.normal.y + rz*m.normal.z)
+                                 * (Real(0.25)/Math::pi<Real>()) / (r2*std::sqrt(r2));
+                             return false;
+                         } else {
+                             return true;
+                         }
+                     },
+                     [&] (int tr) {
+                         w += tri_winding_number(p, tri_pts[tr]);
+                     });
+        return w;
+    }
 }
 
 void
@@ -307,6 +522,8 @@ STLtools::prepare ()
         amrex::Print() << "    Min: " << m_ptmin << " Max: " << m_ptmax << '\n';
     }
 
+    build_bvh();
+
     // Choose a reference point by extending the normal vector of the first
     // triangle until it's slightly outside the bounding box.
     XDim3 cent0; // centroid of the first triangle
@@ -415,16 +632,185 @@ STLtools::prepare ()
     m_boundry_is_outside = num_isects % 2 == 0;
 }
 
+void
+STLtools::build_bvh ()
+{
+    // The hierarchy is built on the host by recursive median splits along
+    // the longest axis of the triangle centroids.  This bounds the depth to
+    // about log2(m_num_tri/bvh_leaf_size).
+    const int ntri = m_num_tri;
+    Vector<XDim3> tri_lo(ntri), tri_hi(ntri), tri_cent(ntri);
+    for (int i = 0; i < ntri; ++i) {
+        auto const& tri = m_tri_pts_h[i];
+        tri_lo[i] = XDim3{amrex::min(tri.v1.x,tri.v2.x,tri.v3.x),
+                          amrex::min(tri.v1.y,tri.v2.y,tri.v3.y),
+                          amrex::min(tri.v1.z,tri.v2.z,tri.v3.z)};
+        tri_hi[i] = XDim3{amrex::max(tri.v1.x,tri.v2.x,tri.v3.x),
+                          amrex::max(tri.v1.y,tri.v2.y,tri.v3.y),
+                          amrex::max(tri.v1.z,tri.v2.z,tri.v3.z)};
+        tri_cent[i] = XDim3{(tri.v1.x + tri.v2.x + tri.v3.x) / 3._rt,
+                            (tri.v1.y + tri.v2.y + tri.v3.y) / 3._rt,
+                            (tri.v1.z + tri.v2.z + tri.v3.z) / 3._rt};
+    }
+
+    // Node boxes are padded so that roundoff in the traversal tests can
+    // never prune a triangle the exact tests would have found.
+    Real pad = Real(1.e-8) * std::max({m_ptmax.x-m_ptmin.x,
+                                       m_ptmax.y-m_ptmin.y,
+                                       m_ptmax.z-m_ptmin.z,
+                                       std::numeric_limits<Real>::min()});
+
+    Vector<int>& tri_index = m_bvh_tri_index_h;
+    tri_index.resize(ntri);
+    std::iota(tri_index.begin(), tri_index.end(), 0);
+
+    Vector<BVHNode>& nodes = m_bvh_nodes_h;
+    nodes.clear();
+    nodes.reserve(std::max(1, 2*ntri/bvh_leaf_size));
+    nodes.push_back(BVHNode{});
+
+    struct Range { int node, begin, end, depth; };
+    Vector<Range> work{Range{0, 0, ntri, 1}};
+    int max_depth = 0;
+    while (!work.empty()) {
+        Range r = work.back();
+        work.pop_back();
+        max_depth = std::max(max_depth, r.depth);
+
+        XDim3 lo{ std::numeric_limits<Real>::max(),  std::numeric_limits<Real>::max(),
+                  std::numeric_limits<Real>::max()};
+        XDim3 hi{std::numeric_limits<Real>::lowest(), std::numeric_limits<Real>::lowest(),
+                 std::numeric_limits<Real>::lowest()};
+        XDim3 clo = lo, chi = hi;
+        for (int n = r.begin; n < r.end; ++n) {
+            int i = tri_index[n];
+            lo.x = std::min(lo.x, tri_lo[i].x);
+            lo.y = std::min(lo.y, tri_lo[i].y);
+            lo.z = std::min(lo.z, tri_lo[i].z);
+            hi.x = std::max(hi.x, tri_hi[i].x);
+            hi.y = std::max(hi.y, tri_hi[i].y);
+            hi.z = std::max(hi.z, tri_hi[i].z);
+            clo.x = std::min(clo.x, tri_cent[i].x);
+            clo.y = std::min(clo.y, tri_cent[i].y);
+            clo.z = std::min(clo.z, tri_cent[i].z);
+            chi.x = std::max(chi.x, tri_cent[i].x);
+            chi.y = std::max(chi.y, tri_cent[i].y);
+            chi.z = std::max(chi.z, tri_cent[i].z);
+        }
+
+        BVHNode& node = nodes[r.node];
+        node.lo = XDim3{lo.x-pad, lo.y-pad, lo.z-pad};
+        node.hi = XDim3{hi.x+pad, hi.y+pad, hi.z+pad};
+
+        if (r.end - r.begin <= bvh_leaf_size) {
+            node.first = r.begin;
+            node.count = r.end - r.begin;
+        } else {
+            Real ex = chi.x-clo.x, ey = chi.y-clo.y, ez = chi.z-clo.z;
+            int axis = (ex >= ey && ex >= ez) ? 0 : ((ey >= ez) ? 1 : 2);
+            int mid = r.begin + (r.end - r.begin) / 2;
+            std::nth_element(tri_index.begin()+r.begin, tri_index.begin()+mid,
+                             tri_index.begin()+r.end,
+                             [&] (int a, int b) {
+                                 Real const* ca = &(tri_cent[a].x);
+                                 Real const* cb = &(tri_cent[b].x);
+                                 return ca[axis] < cb[axis];
+                             });
+            int left = static_cast<int>(nodes.size());
+            node.first = left;
+            node.count = 0;
+            nodes.push_back(BVHNode{}); // node may dangle from here on
+            nodes.push_back(BVHNode{});
+            work.push_back(Range{left  , r.begin, mid  , r.depth+1});
+            work.push_back(Range{left+1, mid    , r.end, r.depth+1});
+        }
+    }
+    AMREX_ALWAYS_ASSERT(max_depth < bvh_max_depth);
+
+    // Children have larger indices than their parents, so the moments can
+    // be accumulated in reverse order.
+    Vector<BVHMoment>& moments = m_bvh_moments_h;
+    moments.resize(nodes.size());
+    Vector<Real> area(nodes.size());
+    for (int inode = static_cast<int>(nodes.size())-1; inode >= 0; --inode) {
+        auto const& node = nodes[inode];
+        auto& m = moments[inode];
+        XDim3 c{0._rt, 0._rt, 0._rt};
+        XDim3 nrm{0._rt, 0._rt, 0._rt};
+        Real a = 0._rt;
+        int nchildren = (node.count > 0) ? node.count : 2;
+        for (int n = 0; n < nchildren; ++n) {
+            XDim3 cc, nn;
+            Real aa;
+            if (node.count > 0) {
+                auto const& tri = m_tri_pts_h[tri_index[node.first+n]];
+                XDim3 e1{tri.v2.x-tri.v1.x, tri.v2.y-tri.v1.y, tri.v2.z-tri.v1.z};
+                XDim3 e2{tri.v3.x-tri.v1.x, tri.v3.y-tri.v1.y, tri.v3.z-tri.v1.z};
+                nn = XDim3{0.5_rt*(e1.y*e2.z-e1.z*e2.y),
+                           0.5_rt*(e1.z*e2.x-e1.x*e2.z),
+                           0.5_rt*(e1.x*e2.y-e1.y*e2.x)};
+                aa = std::sqrt(nn.x*nn.x + nn.y*nn.y + nn.z*nn.z);
+                cc = tri_cent[tri_index[node.first+n]];
+            } else {
+                nn = moments[node.first+n].normal;
+                aa = area[node.first+n];
+                cc = moments[node.first+n].center;
+            }
+            c.x += aa*cc.x;
+            c.y += aa*cc.y;
+            c.z += aa*cc.z;
+            nrm.x += nn.x;
+            nrm.y += nn.y;
+            nrm.z += nn.z;
+            a += aa;
+        }
+        if (a > 0._rt) {
+            c = XDim3{c.x/a, c.y/a, c.z/a};
+        } else {
+            c = XDim3{0.5_rt*(node.lo.x+node.hi.x), 0.5_rt*(node.lo.y+node.hi.y),
+                      0.5_rt*(node.lo.z+node.hi.z)};
+        }
+        auto dist = [&] (XDim3 const& q) {
+            return std::sqrt((q.x-c.x)*(q.x-c.x) + (q.y-c.y)*(q.y-c.y) + (q.z-c.z)*(q.z-c.z));
+        };
+        Real radius = 0._rt;
+        for (int n = 0; n < nchildren; ++n) {
+            if (node.count > 0) {
+                auto const& tri = m_tri_pts_h[tri_index[node.first+n]];
+                radius = std::max({radius, dist(tri.v1), dist(tri.v2), dist(tri.v3)});
+            } else {
+                auto const& mc = moments[node.first+n];
+                radius = std::max(radius, dist(mc.center) + mc.radius);
+            }
+        }
+        m = BVHMoment{c, nrm, radius};
+        area[inode] = a;
+    }
+
+    if (amrex::Verbose() > 0) {
+        amrex::Print() << "    BVH nodes: " << nodes.size() << " depth: " << max_depth << '\n';
+    }
+
+    m_bvh_nodes_d.resize(nodes.size());
+    m_bvh_tri_index_d.resize(ntri);
+    m_bvh_moments_d.resize(moments.size());
+    Gpu::copyAsync(Gpu::hostToDevice, nodes.begin(), nodes.end(), m_bvh_nodes_d.begin());
+    Gpu::copyAsync(Gpu::hostToDevice, moments.begin(), moments.end(), m_bvh_moments_d.begin());
+    Gpu::copyAsync(Gpu::hostToDevice, tri_index.begin(), tri_index.end(),
+                   m_bvh_tri_index_d.begin());
+    Gpu::streamSynchronize();
+}
+
 void
 STLtools::fill (MultiFab& mf, IntVect const& nghost, Geometry const& geom,
                 Real outside_value, Real inside_value) const
 {
-    int num_triangles = m_num_tri;
-
     const auto plo = geom.ProbLoArray();
     const auto dx  = geom.CellSizeArray();
 
     const Triangle* tri_pts = m_tri_pts_d.data();
+    const BVHNode* bvh_nodes = m_bvh_nodes_d.data();
+    const int* bvh_tri_index = m_bvh_tri_index_d.data();
     XDim3 ptmin = m_ptmin;
     XDim3 ptmax = m_ptmax;
     XDim3 ptref = m_ptref;
@@ -449,17 +835,147 @@ STLtools::fill (MultiFab& mf, IntVect const& nghost, Geometry const& geom,
             coords[2] >= ptmin.z && coords[2] <= ptmax.z)
         {
             Real pr[]={ptref.x, ptref.y, ptref.z};
-            for (int tr=0; tr < num_triangles; ++tr) {
-                if (line_tri_intersects(pr, coords, tri_pts[tr])) {
-                    ++num_intersects;
-                }
-            }
+            num_intersects = num_line_intersects(pr, coords, tri_pts, bvh_nodes, bvh_tri_index);
         }
         ma[box_no](i,j,k) = (num_intersects % 2 == 0) ? reference_value : other_value;
     });
     Gpu::streamSynchronize();
 }
 
+bool
+STLtools::isNearSurface (XDim3 const& lo, XDim3 const& hi) const
+{
+    if (lo.x > m_ptmax.x || lo.y > m_ptmax.y || lo.z > m_ptmax.z ||
+        hi.x < m_ptmin.x || hi.y < m_ptmin.y || hi.z < m_ptmin.z)
+    {
+        return false;
+    }
+
+    const Triangle* tri_pts = m_tri_pts_h.data();
+    bool near = false;
+    bvh_for_each(m_bvh_nodes_h.data(), m_bvh_tri_index_h.data(),
+                 [&] (BVHNode const& node) {
+                     return !near &&
+                         !(lo.x > node.hi.x || lo.y > node.hi.y || lo.z > node.hi.z ||
+                           hi.x < node.lo.x || hi.y < node.lo.y || hi.z < node.lo.z);
+                 },
+                 [&] (int tr) {
+                     auto const& tri = tri_pts[tr];
+                     near = near ||
+                         !(lo.x > amrex::max(tri.v1.x,tri.v2.x,tri.v3.x) ||
+                           lo.y > amrex::max(tri.v1.y,tri.v2.y,tri.v3.y) ||
+                           lo.z > amrex::max(tri.v1.z,tri.v2.z,tri.v3.z) ||
+                           hi.x < amrex::min(tri.v1.x,tri.v2.x,tri.v3.x) ||
+                           hi.y < amrex::min(tri.v1.y,tri.v2.y,tri.v3.y) ||
+                           hi.z < amrex::min(tri.v1.z,tri.v2.z,tri.v3.z));
+                 });
+    return near;
+}
+
+bool
+STLtools::isInside (XDim3 const& p) const
+{
+    Real coords[] = {p.x, p.y, p.z};
+    Real w = winding_number(coords, m_tri_pts_h.data(), m_bvh_nodes_h.data(),
+                            m_bvh_moments_h.data(), m_bvh_tri_index_h.data());
+    // If the normals point into the object, the winding number is -1
+    // inside the surface, where the object is not, and 0 outside.
+    return m_boundry_is_outside ? (w > 0.5_rt) : (w > -0.5_rt);
+}
+
+void
+STLtools::fillSignedDistance (MultiFab& mf, IntVect const& nghost, Geometry const& geom,
+                              Real narrow_band) const
+{
+    AMREX_ALWAYS_ASSERT(narrow_band > 0._rt);
+
+    // Boxes near the surface are bisected until they are this small.
+    constexpr int min_box_size = 8;
+
+    const auto plo = geom.ProbLoArray();
+    const auto dx  = geom.CellSizeArray();
+
+    const Triangle* tri_pts = m_tri_pts_d.data();
+    const BVHNode* bvh_nodes = m_bvh_nodes_d.data();
+    const int* bvh_tri_index = m_bvh_tri_index_d.data();
+    const BVHMoment* bvh_moments = m_bvh_moments_d.data();
+    Real winding_threshold = m_boundry_is_outside ? 0.5_rt : -0.5_rt;
+    Real band2 = narrow_band*narrow_band;
+
+    auto position = [&] (IntVect const& iv) -> XDim3
+    {
+        return XDim3{plo[0]+static_cast<Real>(iv[0])*dx[0],
+                     plo[1]+static_cast<Real>(iv[1])*dx[1],
+#if (AMREX_SPACEDIM == 2)
+                     Real(0.)
+#else
+                     plo[2]+static_cast<Real>(iv[2])*dx[2]
+#endif
+        };
+    };
+
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        auto const& a = mf.array(mfi);
+        Vector<Box> boxes{amrex::grow(mfi.validbox(), nghost)};
+        while (!boxes.empty())
+        {
+            Box bx = boxes.back();
+            boxes.pop_back();
+
+            XDim3 lo = position(bx.smallEnd());
+            XDim3 hi = position(bx.bigEnd());
+            int dir;
+            int len = bx.longside(dir);
+            if (!isNearSurface({lo.x-narrow_band, lo.y-narrow_band, lo.z-narrow_band},
+                               {hi.x+narrow_band, hi.y+narrow_band, hi.z+narrow_band}))
+            {
+                // No part of the surface is within narrow_band of this box,
+                // so the whole box is on the same side.
+                Real v = isInside(lo) ? narrow_band : -narrow_band;
+                ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+                {
+                    a(i,j,k) = v;
+                });
+            }
+            else if (len > min_box_size)
+            {
+                Box bx2 = bx.chop(dir, bx.smallEnd(dir) + len/2);
+                boxes.push_back(bx);
+                boxes.push_back(bx2);
+            }
+            else
+            {
+                ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+                {
+                    Real coords[3];
+                    coords[0]=plo[0]+static_cast<Real>(i)*dx[0];
+                    coords[1]=plo[1]+static_cast<Real>(j)*dx[1];
+#if (AMREX_SPACEDIM == 2)
+                    coords[2]=Real(0.);
+#else
+                    coords[2]=plo[2]+static_cast<Real>(k)*dx[2];
+#endif
+                    Real d2 = band2;
+                    bvh_for_each(bvh_nodes, bvh_tri_index,
+                                 [&] (BVHNode const& node) {
+                                     return point_box_dist2(coords, node) < d2;
+                                 },
+                                 [&] (int tr) {
+                                     d2 = amrex::min(d2, point_tri_dist2(coords, tri_pts[tr]));
+                                 });
+
+                    Real w = winding_number(coords, tri_pts, bvh_nodes, bvh_moments,
+                                            bvh_tri_index);
+                    Real sgn = (w > winding_threshold) ? 1._rt : -1._rt;
+                    a(i,j,k) = sgn * std::sqrt(d2);
+                });
+            }
+        }
+    }
+    Gpu::streamSynchronize();
+}
+
 int
 STLtools::getBoxType (Box const& box, Geometry const& geom, RunOn) const
 {
@@ -491,8 +1007,9 @@ STLtools::getBoxType (Box const& box, Geometry const& geom, RunOn) const
     }
     else
     {
-        int num_triangles = m_num_tri;
         const Triangle* tri_pts = m_tri_pts_d.data();
+        const BVHNode* bvh_nodes = m_bvh_nodes_d.data();
+        const int* bvh_tri_index = m_bvh_tri_index_d.data();
         XDim3 ptmin = m_ptmin;
         XDim3 ptmax = m_ptmax;
         XDim3 ptref = m_ptref;
@@ -519,11 +1036,7 @@ STLtools::getBoxType (Box const& box, Geometry const& geom, RunOn) const
                 coords[2] >= ptmin.z && coords[2] <= ptmax.z)
             {
                 Real pr[]={ptref.x, ptref.y, ptref.z};
-                for (int tr=0; tr < num_triangles; ++tr) {
-                    if (line_tri_intersects(pr, coords, tri_pts[tr])) {
-                        ++num_intersects;
-                    }
-                }
+                num_intersects = num_line_intersects(pr, coords, tri_pts, bvh_nodes, bvh_tri_index);
             }
 
             return (num_intersects % 2 == 0) ? ref_value : 1-ref_value;
@@ -544,12 +1057,12 @@ STLtools::getBoxType (Box const& box, Geometry const& geom, RunOn) const
 void
 STLtools::fillFab (BaseFab<Real>& levelset, const Geometry& geom, RunOn, Box const&) const
 {
-    int num_triangles = m_num_tri;
-
     const auto plo = geom.ProbLoArray();
     const auto dx  = geom.CellSizeArray();
 
     const Triangle* tri_pts = m_tri_pts_d.data();
+    const BVHNode* bvh_nodes = m_bvh_nodes_d.data();
+    const int* bvh_tri_index = m_bvh_tri_index_d.data();
     XDim3 ptmin = m_ptmin;
     XDim3 ptmax = m_ptmax;
     XDim3 ptref = m_ptref;
@@ -574,11 +1087,7 @@ STLtools::fillFab (BaseFab<Real>& levelset, const Geometry& geom, RunOn, Box con
             coords[2] >= ptmin.z && coords[2] <= ptmax.z)
         {
             Real pr[]={ptref.x, ptref.y, ptref.z};
-            for (int tr=0; tr < num_triangles; ++tr) {
-                if (line_tri_intersects(pr, coords, tri_pts[tr])) {
-                    ++num_intersects;
-                }
-            }
+            num_intersects = num_line_intersects(pr, coords, tri_pts, bvh_nodes, bvh_tri_index);
         }
         a(i,j,k) = (num_intersects % 2 == 0) ? reference_value : other_value;
     });
@@ -597,6 +1106,8 @@ STLtools::getIntercept (Array<Array4<Real>,AMREX_SPACEDIM> const& inter_arr,
 
     const Triangle* tri_pts = m_tri_pts_d.data();
     const XDim3* tri_norm = m_tri_normals_d.data();
+    const BVHNode* bvh_nodes = m_bvh_nodes_d.data();
+    const int* bvh_tri_index = m_bvh_tri_index_d.data();
 
     for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
         Array4<Real> const& inter = inter_arr[idim];
@@ -614,61 +1125,87 @@ STLtools::getIntercept (Array<Array4<Real>,AMREX_SPACEDIM> const& inter_arr,
                          plo[2]+static_cast<Real>(k)*dx[2]
 #endif
                 };
+                // Among all triangles intersected by the edge, the one
+                // with the lowest index is used so that the result does not
+                // depend on the traversal order.
+                int it_min = num_triangles;
                 if (idim == 0) {
                     Real x2 = plo[0]+static_cast<Real>(i+1)*dx[0];
-                    int it;
-                    for (it=0; it < num_triangles; ++it) {
-                        auto const& tri = tri_pts[it];
-                        auto tmp = edge_tri_intersects(p1.x, x2, p1.y, p1.z,
-                                                       tri.v1, tri.v2, tri.v3,
-                                                       tri_norm[it],
-                                                       lst(i+1,j,k)-lst(i,j,k));
-                        if (tmp.first) {
-                            r = tmp.second;
-                            break;
-                        }
-                    }
-                    if (it == num_triangles) {
+                    Real dlevset = lst(i+1,j,k)-lst(i,j,k);
+                    bvh_for_each(bvh_nodes, bvh_tri_index,
+                                 [&] (BVHNode const& node) {
+                                     return edge_box_intersects(p1.x, x2, p1.y, p1.z,
+                                                                node.lo, node.hi);
+                                 },
+                                 [&] (int it) {
+                                     if (it < it_min) {
+                                         auto const& tri = tri_pts[it];
+                                         auto tmp = edge_tri_intersects(p1.x, x2, p1.y, p1.z,
+                                                                        tri.v1, tri.v2, tri.v3,
+                                                                        tri_norm[it], dlevset);
+                                         if (tmp.first) {
+                                             it_min = it;
+                                             r = tmp.second;
+                                         }
+                                     }
+                                 });
+                    if (it_min == num_triangles) {
                         r = (lst(i,j,k) > 0._rt) ? p1.x : x2;
                     }
                 } else if (idim == 1) {
                     Real y2 = plo[1]+static_cast<Real>(j+1)*dx[1];
-                    int it;
-                    for (it=0; it < num_triangles; ++it) {
-                        auto const& tri = tri_pts[it];
-                        auto const& norm = tri_norm[it];
-                        auto tmp = edge_tri_intersects(p1.y, y2, p1.z, p1.x,
-                                                       {tri.v1.y, tri.v1.z, tri.v1.x},
-                                                       {tri.v2.y, tri.v2.z, tri.v2.x},
-                                                       {tri.v3.y, tri.v3.z, tri.v3.x},
-                                                       {  norm.y,   norm.z,   norm.x},
-                                                       lst(i,j+1,k)-lst(i,j,k));
-                        if (tmp.first) {
-                            r = tmp.second;
-                            break;
-                        }
-                    }
-                    if (it == num_triangles) {
+                    Real dlevset = lst(i,j+1,k)-lst(i,j,k);
+                    bvh_for_each(bvh_nodes, bvh_tri_index,
+                                 [&] (BVHNode const& node) {
+                                     return edge_box_intersects(p1.y, y2, p1.z, p1.x,
+                                                                {node.lo.y, node.lo.z, node.lo.x},
+                                                                {node.hi.y, node.hi.z, node.hi.x});
+                                 },
+                                 [&] (int it) {
+                                     if (it < it_min) {
+                                         auto const& tri = tri_pts[it];
+                                         auto const& norm = tri_norm[it];
+                                         auto tmp = edge_tri_intersects(p1.y, y2, p1.z, p1.x,
+                                                                        {tri.v1.y, tri.v1.z, tri.v1.x},
+                                                                        {tri.v2.y, tri.v2.z, tri.v2.x},
+                                                                        {tri.v3.y, tri.v3.z, tri.v3.x},
+                                                                        {  norm.y,   norm.z,   norm.x},
+                                                                        dlevset);
+                                         if (tmp.first) {
+                                             it_min = it;
+                                             r = tmp.second;
+                                         }
+                                     }
+                                 });
+                    if (it_min == num_triangles) {
                         r = (lst(i,j,k) > 0._rt) ? p1.y : y2;
                     }
                 } else {
                     Real z2 = plo[2]+static_cast<Real>(k+1)*dx[2];
-                    int it;
-                    for (it=0; it < num_triangles; ++it) {
-                        auto const& tri = tri_pts[it];
-                        auto const& norm = tri_norm[it];
-                        auto tmp = edge_tri_intersects(p1.z, z2, p1.x, p1.y,
-                                                       {tri.v1.z, tri.v1.x, tri.v1.y},
-                                                       {tri.v2.z, tri.v2.x, tri.v2.y},
-                                                       {tri.v3.z, tri.v3.x, tri.v3.y},
-                                                       {  norm.z,   norm.x,   norm.y},
-                                                       lst(i,j,k+1)-lst(i,j,k));
-                        if (tmp.first) {
-                            r = tmp.second;
-                            break;
-                        }
-                    }
-                    if (it == num_triangles) {
+                    Real dlevset = lst(i,j,k+1)-lst(i,j,k);
+                    bvh_for_each(bvh_nodes, bvh_tri_index,
+                                 [&] (BVHNode const& node) {
+                                     return edge_box_intersects(p1.z, z2, p1.x, p1.y,
+                                                                {node.lo.z, node.lo.x, node.lo.y},
+                                                                {node.hi.z, node.hi.x, node.hi.y});
+                                 },
+                                 [&] (int it) {
+                                     if (it < it_min) {
+                                         auto const& tri = tri_pts[it];
+                                         auto const& norm = tri_norm[it];
+                                         auto tmp = edge_tri_intersects(p1.z, z2, p1.x, p1.y,
+                                                                        {tri.v1.z, tri.v1.x, tri.v1.y},
+                                                                        {tri.v2.z, tri.v2.x, tri.v2.y},
+                                                                        {tri.v3.z, tri.v3.x, tri.v3.y},
+                                                                        {  norm.z,   norm.x,   norm.y},
+                                                                        dlevset);
+                                         if (tmp.first) {
+                                             it_min = it;
+                                             r = tmp.second;
+                                         }
+                                     }
+                                 });
+                    if (it_min == num_triangles) {
                         r = (lst(i,j,k) > 0._rt) ? p1.z : z2;
                     }
                 }
@@ -98,13 +98,6 @@ MLStateRedistribute ( Box const& bx, int ncomp,
     FArrayBox    Qhat_fab (bxg3,ncomp,The_Async_Arena());
     Array4<Real> Qhat = Qhat_fab.array();
 
-#if (AMREX_SPACEDIM == 2)
-    FArrayBox qtracker_fab (bxg3,4,The_Async_Arena());
-#elif (AMREX_SPACEDIM == 3)
-    FArrayBox qtracker_fab (bxg3,8,The_Async_Arena());
-#endif
-    Array4<Real> qt = qtracker_fab.array();
-
     // Initialize to zero just in case
     if (as_fine) {
         amrex::ParallelFor(bx, ncomp,
@@ -114,8 +107,9 @@ MLStateRedistribute ( Box const& bx, int ncomp,
         });
     }
 
-    for (int n = 0; n < ncomp; n++)
-    {
+    // All components are handled in the same pass over the cells so that the
+    //      neighborhood data (itracker, alpha, nrs, nbhd_vol, cent_hat) are only
+    //      read once per cell rather than once per component.
 
     // Define Qhat (from Berger and Guliani)
     // Here we initialize Qhat to equal U_in on all cells in bxg3 so that
@@ -128,7 +122,9 @@ MLStateRedistribute ( Box const& bx, int ncomp,
         if (vfrac(i,j,k) > 0.0 && bxg2.contains(IntVect(AMREX_D_DECL(i,j,k)))
                                && domain_per_grown.contains(IntVect(AMREX_D_DECL(i,j,k))))
         {
-            Qhat(i,j,k,n) = 0.;
+            for (int n = 0; n < ncomp; n++) {
+                Qhat(i,j,k,n) = 0.;
+            }
 
             // This loops over (i,j,k) and the neighbors of (i,j,k)
             for (int i_nbor = 0; i_nbor <= itracker(i,j,k,0); i_nbor++)
@@ -144,12 +140,15 @@ MLStateRedistribute ( Box const& bx, int ncomp,
 
                 if (domain_per_grown.contains(IntVect(AMREX_D_DECL(r,s,t))))
                 {
-                    qt(i,j,k,i_nbor) = fac * U_in(r,s,t,n) * vfrac(r,s,t) / nbhd_vol(i,j,k);
-                    Qhat(i,j,k,n) += qt(i,j,k,i_nbor);
+                    for (int n = 0; n < ncomp; n++) {
+                        Qhat(i,j,k,n) += fac * U_in(r,s,t,n) * vfrac(r,s,t) / nbhd_vol(i,j,k);
+                    }
                 }
             }
         } else {
-            Qhat(i,j,k,n) = U_in(i,j,k,n);
+            for (int n = 0; n < ncomp; n++) {
+                Qhat(i,j,k,n) = U_in(i,j,k,n);
+            }
         }
     });
 
@@ -162,59 +161,73 @@ MLStateRedistribute ( Box const& bx, int ncomp,
     {
         if (vfrac(i,j,k) > 0.0)
         {
-            // This loops over (i,j,k) and the neighbors of (i,j,k)
+            // Skip the slopes if neither (i,j,k) nor any of its neighbors is in the domain
+            bool has_target = false;
             for (int i_nbor = 0; i_nbor <= itracker(i,j,k,0); i_nbor++)
             {
                 int r = i; int s = j; int t = k;
-                Real fac = alpha(i,j,k,0) * nrs(i,j,k);
                 if (i_nbor > 0) {
                     r += imap[itracker(i,j,k,i_nbor)];
                     s += jmap[itracker(i,j,k,i_nbor)];
                     t += kmap[itracker(i,j,k,i_nbor)];
-                    fac = alpha(i,j,k,1);
                 }
+                has_target = has_target || domain_per_grown.contains(IntVect(AMREX_D_DECL(r,s,t)));
+            }
+            if (!has_target) { return; }
 
-                if (domain_per_grown.contains(IntVect(AMREX_D_DECL(r,s,t))))
-                {
-                    // Initialize so that the slope stencil goes from -1:1 in each direction
-                    int nx = 1; int ny = 1; int nz = 1;
+            // Initialize so that the slope stencil goes from -1:1 in each direction
+            int nx = 1; int ny = 1; int nz = 1;
 
-                    // Do we have enough extent in each coordinate direction to use the 3x3x3 stencil
-                    //    or do we need to enlarge it?
-                    AMREX_D_TERM(Real x_max = -Real(1.e30); Real x_min = Real(1.e30);,
-                                 Real y_max = -Real(1.e30); Real y_min = Real(1.e30);,
-                                 Real z_max = -Real(1.e30); Real z_min = Real(1.e30););
+            // A cell that is not merged with any other cell has cent_hat == ccent, so
+            //    its slopes would only be multiplied by zero and are not needed
+            const bool need_slopes = itracker(i,j,k,0) > 0;
+
+            if (need_slopes)
+            {
+                // Do we have enough extent in each coordinate direction to use the 3x3x3 stencil
+                //    or do we need to enlarge it?
+                AMREX_D_TERM(Real x_max = -Real(1.e30); Real x_min = Real(1.e30);,
+                             Real y_max = -Real(1.e30); Real y_min = Real(1.e30);,
+                             Real z_max = -Real(1.e30); Real z_min = Real(1.e30););
 
-                    Real slope_stencil_min_width = Real(0.5);
+                Real slope_stencil_min_width = Real(0.5);
 #if (AMREX_SPACEDIM == 2)
-                    int kkk = 0;
+                int kkk = 0;
 #elif (AMREX_SPACEDIM == 3)
-                    for(int kkk(-1); kkk<=1; kkk++) {
+                for(int kkk(-1); kkk<=1; kkk++) {
 #endif
-                    for(int jjj(-1); jjj<=1; jjj++) {
-                    for(int iii(-1); iii<=1; iii++) {
-                         if (flag(i,j,k).isConnected(iii,jjj,kkk))
-                         {
-                             int rr = i+iii; int ss = j+jjj; int tt = k+kkk;
-
-                                x_max = amrex::max(x_max, cent_hat(rr,ss,tt,0)+static_cast<Real>(iii));
-                                x_min = amrex::min(x_min, cent_hat(rr,ss,tt,0)+static_cast<Real>(iii));
-                                y_max = amrex::max(y_max, cent_hat(rr,ss,tt,1)+static_cast<Real>(jjj));
-                                y_min = amrex::min(y_min, cent_hat(rr,ss,tt,1)+static_cast<Real>(jjj));
+                for(int jjj(-1); jjj<=1; jjj++) {
+                for(int iii(-1); iii<=1; iii++) {
+                     if (flag(i,j,k).isConnected(iii,jjj,kkk))
+                     {
+                         int rr = i+iii; int ss = j+jjj; int tt = k+kkk;
+
+                            x_max = amrex::max(x_max, cent_hat(rr,ss,tt,0)+static_cast<Real>(iii));
+                            x_min = amrex::min(x_min, cent_hat(rr,ss,tt,0)+static_cast<Real>(iii));
+                            y_max = amrex::max(y_max, cent_hat(rr,ss,tt,1)+static_cast<Real>(jjj));
+                            y_min = amrex::min(y_min, cent_hat(rr,ss,tt,1)+static_cast<Real>(jjj));
 #if (AMREX_SPACEDIM == 3)
-                                z_max = amrex::max(z_max, cent_hat(rr,ss,tt,2)+static_cast<Real>(kkk));
-                                z_min = amrex::min(z_min, cent_hat(rr,ss,tt,2)+static_cast<Real>(kkk));
+                            z_max = amrex::max(z_max, cent_hat(rr,ss,tt,2)+static_cast<Real>(kkk));
+                            z_min = amrex::min(z_min, cent_hat(rr,ss,tt,2)+static_cast<Real>(kkk));
 #endif
-                         }
-                    AMREX_D_TERM(},},})
+                     }
+                AMREX_D_TERM(},},})
 
-                    // If we need to grow the stencil, we let it be -nx:nx in the x-direction,
-                    //    for example.   Note that nx,ny,nz are either 1 or 2
-                    if ( (x_max-x_min) < slope_stencil_min_width ) { nx = 2; }
-                    if ( (y_max-y_min) < slope_stencil_min_width ) { ny = 2; }
+                // If we need to grow the stencil, we let it be -nx:nx in the x-direction,
+                //    for example.   Note that nx,ny,nz are either 1 or 2
+                if ( (x_max-x_min) < slope_stencil_min_width ) { nx = 2; }
+                if ( (y_max-y_min) < slope_stencil_min_width ) { ny = 2; }
 #if (AMREX_SPACEDIM == 3)
-                    if ( (z_max-z_min) < slope_stencil_min_width ) { nz = 2; }
+                if ( (z_max-z_min) < slope_stencil_min_width ) { nz = 2; }
 #endif
+            }
+
+            for (int n = 0; n < ncomp; n++)
+            {
+                amrex::GpuArray<amrex::Real,AMREX_SPACEDIM> lim_slope{AMREX_D_DECL(Real(0.),Real(0.),Real(0.))};
+
+                if (need_slopes)
+                {
                     bool extdir_ilo = (d_bcrec_ptr[n].lo(0) == amrex::BCType::ext_dir ||
                                        d_bcrec_ptr[n].lo(0) == amrex::BCType::hoextrap);
                     bool extdir_ihi = (d_bcrec_ptr[n].hi(0) == amrex::BCType::ext_dir ||
@@ -231,7 +244,8 @@ MLStateRedistribute ( Box const& bx, int ncomp,
 #endif
 
                     // Compute slopes of Qhat (which is the sum of the qt's) then use
-                    //  that for each qt separately
+                    //  that for each qt separately.  The slopes only depend on (i,j,k),
+                    //  so they are shared by all the neighbors of (i,j,k).
                     amrex::GpuArray<amrex::Real,AMREX_SPACEDIM> slopes_eb;
                     if (nx*ny*nz == 1) {
                         // Compute slope using 3x3x3 stencil
@@ -259,12 +273,27 @@ MLStateRedistribute ( Box const& bx, int ncomp,
                     // We do the limiting separately because this limiter limits the slope based on the values
                     //    extrapolated to the cell centroid (cent_hat) locations - unlike the limiter in amrex
                     //    which bases the limiting on values extrapolated to the face centroids.
-                    amrex::GpuArray<amrex::Real,AMREX_SPACEDIM> lim_slope =
+                    lim_slope =
                         amrex_calc_centroid_limiter(i,j,k,n,Qhat,flag,slopes_eb,cent_hat);
 
                     AMREX_D_TERM(lim_slope[0] *= slopes_eb[0];,
                                  lim_slope[1] *= slopes_eb[1];,
                                  lim_slope[2] *= slopes_eb[2];);
+                }
+
+                // This loops over (i,j,k) and the neighbors of (i,j,k)
+                for (int i_nbor = 0; i_nbor <= itracker(i,j,k,0); i_nbor++)
+                {
+                    int r = i; int s = j; int t = k;
+                    Real fac = alpha(i,j,k,0) * nrs(i,j,k);
+                    if (i_nbor > 0) {
+                        r += imap[itracker(i,j,k,i_nbor)];
+                        s += jmap[itracker(i,j,k,i_nbor)];
+                        t += kmap[itracker(i,j,k,i_nbor)];
+                        fac = alpha(i,j,k,1);
+                    }
+
+                    if (!domain_per_grown.contains(IntVect(AMREX_D_DECL(r,s,t)))) { continue; }
 
                     for (int r_nbor = 0; r_nbor <= itracker(i,j,k,0); r_nbor++)
                     {
@@ -285,7 +314,11 @@ MLStateRedistribute ( Box const& bx, int ncomp,
                         //
                         Real q_over_Q = fac2*vfrac(ii,jj,kk)/nbhd_vol(i,j,k);
 
-                        Real update = qt(i,j,k,r_nbor);
+                        // This is the contribution of U_in(ii,jj,kk) to Qhat(i,j,k)
+                        Real update = 0.;
+                        if (domain_per_grown.contains(IntVect(AMREX_D_DECL(ii,jj,kk)))) {
+                            update = fac2 * U_in(ii,jj,kk,n) * vfrac(ii,jj,kk) / nbhd_vol(i,j,k);
+                        }
                         AMREX_D_TERM(update += q_over_Q * lim_slope[0] *
                                                (ccent(r,s,t,0)-cent_hat(i,j,k,0) + static_cast<Real>(r-i));,
                                      update += q_over_Q * lim_slope[1] *
@@ -336,17 +369,11 @@ MLStateRedistribute ( Box const& bx, int ncomp,
                         } // as_fine
 
                     } // r_nbor
-                } // bx contains
-            } // i_nbor
+                } // i_nbor
+            } // n
         } // vfrac
     });
 
-    //
-    // ****************************************************************************************
-    //
-
-    } // loop over n = 0, ncomp-1
-
     amrex::ParallelFor(bx,ncomp,
     [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
     {
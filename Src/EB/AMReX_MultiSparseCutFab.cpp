@@ -0,0 +1,191 @@
+
+#include <AMReX_MultiSparseCutFab.H>
+#include <AMReX_MultiCutFab.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Scan.H>
+
+namespace amrex {
+
+MultiSparseCutFab::MultiSparseCutFab (const MultiCutFab& src,
+                                      const FabArray<EBCellFlagFab>& cellflags,
+                                      Real regular_value, Real covered_value)
+{
+    define(src, cellflags, regular_value, covered_value);
+}
+
+MultiSparseCutFab::MultiSparseCutFab (const MultiFab& src,
+                                      const FabArray<EBCellFlagFab>& cellflags,
+                                      Real regular_value, Real covered_value)
+{
+    define(src, cellflags, regular_value, covered_value);
+}
+
+void
+MultiSparseCutFab::define (const MultiCutFab& src, const FabArray<EBCellFlagFab>& cellflags,
+                           Real regular_value, Real covered_value)
+{
+    m_regular_value = regular_value;
+    m_covered_value = covered_value;
+    build(src.data(), cellflags);
+}
+
+void
+MultiSparseCutFab::define (const MultiFab& src, const FabArray<EBCellFlagFab>& cellflags,
+                           Real regular_value, Real covered_value)
+{
+    m_regular_value = regular_value;
+    m_covered_value = covered_value;
+    build(src, cellflags);
+}
+
+template <class FAB>
+void
+MultiSparseCutFab::build (const FabArray<FAB>& src, const FabArray<EBCellFlagFab>& cellflags)
+{
+    BL_PROFILE("MultiSparseCutFab::build()");
+
+    m_ba = src.boxArray();
+    m_dm = src.DistributionMap();
+    m_ncomp = src.nComp();
+    m_ngrow = src.nGrow();
+    m_cellflags = &cellflags;
+    m_cells.define(m_ba, m_dm);
+    m_data.define(m_ba, m_dm);
+
+    const IntVect nodal = m_ba.ixType().toIntVect();
+    AMREX_ALWAYS_ASSERT(nodal != IntVect::TheZeroVector() || cellflags.nGrow() >= m_ngrow);
+
+    const int ncomp = m_ncomp;
+    for (MFIter mfi(src); mfi.isValid(); ++mfi)
+    {
+        if (cellflags[mfi].getType() != FabType::singlevalued) { continue; }
+
+        const Box& bx = mfi.fabbox();
+        const auto npts = static_cast<int>(bx.numPts());
+        const auto& flag = cellflags.const_array(mfi);
+        const auto& a = src.const_array(mfi);
+
+        auto is_cut = [=] AMREX_GPU_DEVICE (int icell) -> bool
+        {
+            GpuArray<int,3> ijk = bx.atOffset3d(icell);
+            IntVect iv(AMREX_D_DECL(ijk[0],ijk[1],ijk[2]));
+            return SparseCutArray4::pointType(flag, nodal, iv) == SparseCutArray4::stored;
+        };
+
+        Gpu::DeviceVector<int> offset(npts);
+        int* p_offset = offset.data();
+        int ncut = Scan::PrefixSum<int>(npts,
+            [=] AMREX_GPU_DEVICE (int icell) -> int
+            {
+                return static_cast<int>(is_cut(icell));
+            },
+            [=] AMREX_GPU_DEVICE (int icell, int const& x)
+            {
+                p_offset[icell] = x;
+            },
+            Scan::Type::exclusive, Scan::retSum);
+
+        auto& cells = m_cells[mfi];
+        auto& data = m_data[mfi];
+        cells.resize(ncut);
+        data.resize(std::size_t(ncut)*ncomp);
+        int* p_cells = cells.data();
+        Real* p_data = data.data();
+        ParallelFor(npts, [=] AMREX_GPU_DEVICE (int icell) noexcept
+        {
+            if (is_cut(icell)) {
+                GpuArray<int,3> ijk = bx.atOffset3d(icell);
+                int m = p_offset[icell];
+                p_cells[m] = icell;
+                for (int n = 0; n < ncomp; ++n) {
+                    p_data[n*ncut+m] = a(ijk[0],ijk[1],ijk[2],n);
+                }
+            }
+        });
+        Gpu::streamSynchronize();
+    }
+}
+
+SparseCutArray4
+MultiSparseCutFab::const_array (const MFIter& mfi) const noexcept
+{
+    SparseCutArray4 r;
+    auto const& cells = m_cells[mfi];
+    auto const& data = m_data[mfi];
+    r.cells = cells.data();
+    r.data = data.data();
+    r.ncut = static_cast<int>(cells.size());
+    r.ncomp = m_ncomp;
+    r.nodal = m_ba.ixType().toIntVect();
+    const Box bx = amrex::grow(m_ba[mfi.index()], m_ngrow);
+    r.begin = amrex::lbound(bx);
+    r.jstride = bx.length(0);
+#if (AMREX_SPACEDIM == 3)
+    r.kstride = r.jstride * bx.length(1);
+#endif
+    r.regular_value = m_regular_value;
+    r.covered_value = m_covered_value;
+    r.flag = m_cellflags->const_array(mfi);
+    return r;
+}
+
+int
+MultiSparseCutFab::numCutCells (const MFIter& mfi) const noexcept
+{
+    return static_cast<int>(m_cells[mfi].size());
+}
+
+Long
+MultiSparseCutFab::nBytes () const noexcept
+{
+    Long r = 0;
+    for (MFIter mfi(m_cells); mfi.isValid(); ++mfi) {
+        r += static_cast<Long>(m_cells[mfi].size()*sizeof(int) +
+                               m_data[mfi].size()*sizeof(Real));
+    }
+    return r;
+}
+
+MultiFab
+MultiSparseCutFab::ToMultiFab () const
+{
+    MultiFab mf(m_ba, m_dm, m_ncomp, m_ngrow);
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        Box const& b = mfi.fabbox();
+        Array4<Real> const& d = mf.array(mfi);
+        SparseCutArray4 const s = const_array(mfi);
+        ParallelFor(b, m_ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            d(i,j,k,n) = s(i,j,k,n);
+        });
+    }
+    return mf;
+}
+
+void
+MultiSparseCutFab::copyTo (MultiCutFab& dst) const
+{
+    AMREX_ASSERT(dst.boxArray() == m_ba && dst.DistributionMap() == m_dm &&
+                 dst.nComp() == m_ncomp && dst.nGrow() >= m_ngrow);
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(dst.data()); mfi.isValid(); ++mfi)
+    {
+        if (dst.ok(mfi)) {
+            Box const& b = amrex::grow(mfi.validbox(), m_ngrow);
+            Array4<Real> const& d = dst.array(mfi);
+            SparseCutArray4 const s = const_array(mfi);
+            ParallelFor(b, m_ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                d(i,j,k,n) = s(i,j,k,n);
+            });
+        }
+    }
+}
+
+}
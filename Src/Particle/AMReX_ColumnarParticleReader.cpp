@@ -0,0 +1,220 @@
+
+#include <AMReX_ColumnarParticleReader.H>
+#include <AMReX_iMultiFab.H>
+#include <AMReX_NFiles.H>
+#include <AMReX_ParticleContainerBase.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Utility.H>
+#include <AMReX_VectorIO.H>
+
+#include <fstream>
+#include <sstream>
+
+namespace amrex {
+
+ColumnarParticleReader::ColumnarParticleReader (const std::string& dir)
+    : m_dir(dir)
+{
+    if (!m_dir.empty() && m_dir.back() == '/') { m_dir.pop_back(); }
+
+    Vector<char> fileCharPtr;
+    ParallelDescriptor::ReadAndBcastFile(m_dir + "/Header", fileCharPtr);
+    std::string fileCharPtrString(fileCharPtr.dataPtr());
+    std::istringstream HdrFile(fileCharPtrString, std::istringstream::in);
+
+    std::string version;
+    HdrFile >> version;
+    if (version.find("Columnar_Particles_V1") == std::string::npos) {
+        amrex::Abort("ColumnarParticleReader: unknown version string: " + version);
+    }
+    m_single = (version.find("_single") != std::string::npos);
+
+    int dm;
+    HdrFile >> dm;
+    if (dm != AMREX_SPACEDIM) {
+        amrex::Abort("ColumnarParticleReader: dm != AMREX_SPACEDIM");
+    }
+
+    int nreal;
+    HdrFile >> nreal;
+    m_real_names.resize(nreal);
+    for (auto& s : m_real_names) { HdrFile >> s; }
+
+    int nint;
+    HdrFile >> nint;
+    m_int_names.resize(nint);
+    for (auto& s : m_int_names) { HdrFile >> s; }
+
+    Long maxnextid;
+    HdrFile >> m_nparticles >> maxnextid >> m_finest_level;
+
+    const int nlevs = m_finest_level+1;
+    m_which.resize(nlevs);
+    m_count.resize(nlevs);
+    m_where.resize(nlevs);
+    m_real_min.resize(nlevs);
+    m_real_max.resize(nlevs);
+    m_int_min.resize(nlevs);
+    m_int_max.resize(nlevs);
+    for (int lev = 0; lev < nlevs; ++lev) {
+        int ngrids;
+        HdrFile >> ngrids;
+        m_which[lev].resize(ngrids);
+        m_count[lev].resize(ngrids);
+        m_where[lev].resize(ngrids);
+        m_real_min[lev].resize(std::size_t(ngrids)*nreal, std::numeric_limits<ParticleReal>::max());
+        m_real_max[lev].resize(std::size_t(ngrids)*nreal, std::numeric_limits<ParticleReal>::lowest());
+        m_int_min[lev].resize(std::size_t(ngrids)*nint, std::numeric_limits<int>::max());
+        m_int_max[lev].resize(std::size_t(ngrids)*nint, std::numeric_limits<int>::lowest());
+        for (int j = 0; j < ngrids; ++j) {
+            HdrFile >> m_which[lev][j] >> m_count[lev][j] >> m_where[lev][j];
+            if (m_count[lev][j] == 0) { continue; }
+            for (int comp = 0; comp < nreal; ++comp) {
+                HdrFile >> m_real_min[lev][std::size_t(j)*nreal+comp]
+                        >> m_real_max[lev][std::size_t(j)*nreal+comp];
+            }
+            for (int comp = 0; comp < nint; ++comp) {
+                HdrFile >> m_int_min[lev][std::size_t(j)*nint+comp]
+                        >> m_int_max[lev][std::size_t(j)*nint+comp];
+            }
+        }
+    }
+
+    if (HdrFile.fail()) {
+        amrex::Abort("ColumnarParticleReader: problem reading " + m_dir + "/Header");
+    }
+}
+
+int
+ColumnarParticleReader::realComp (const std::string& name) const noexcept
+{
+    for (int i = 0; i < static_cast<int>(m_real_names.size()); ++i) {
+        if (m_real_names[i] == name) { return i; }
+    }
+    return -1;
+}
+
+int
+ColumnarParticleReader::intComp (const std::string& name) const noexcept
+{
+    for (int i = 0; i < static_cast<int>(m_int_names.size()); ++i) {
+        if (m_int_names[i] == name) { return i; }
+    }
+    return -1;
+}
+
+std::pair<ParticleReal,ParticleReal>
+ColumnarParticleReader::realMinMax (int lev, int grid, int comp) const noexcept
+{
+    const std::size_t i = std::size_t(grid)*m_real_names.size() + comp;
+    return {m_real_min[lev][i], m_real_max[lev][i]};
+}
+
+std::pair<int,int>
+ColumnarParticleReader::intMinMax (int lev, int grid, int comp) const noexcept
+{
+    const std::size_t i = std::size_t(grid)*m_int_names.size() + comp;
+    return {m_int_min[lev][i], m_int_max[lev][i]};
+}
+
+Vector<int>
+ColumnarParticleReader::gridsIntersecting (int lev, const RealBox& rb) const
+{
+    Vector<int> r;
+    for (int grid = 0; grid < numGrids(lev); ++grid) {
+        if (m_count[lev][grid] == 0) { continue; }
+        bool overlap = true;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            auto [lo, hi] = realMinMax(lev, grid, idim);
+            overlap = overlap && (hi >= rb.lo(idim)) && (lo <= rb.hi(idim));
+        }
+        if (overlap) { r.push_back(grid); }
+    }
+    return r;
+}
+
+std::string
+ColumnarParticleReader::fileName (int lev, int grid) const
+{
+    std::string prefix = amrex::Concatenate(m_dir + "/Level_", lev, 1);
+    prefix += '/';
+    prefix += ParticleContainerBase::DataPrefix();
+    return NFilesIter::FileName(m_which[lev][grid], prefix);
+}
+
+Long
+ColumnarParticleReader::columnOffset (int lev, int grid, int column) const
+{
+    // The columns of a grid are the ids, the cpus, the reals and the ints.
+    const Long rsize = m_single ? sizeof(float) : sizeof(double);
+    Long nbytes = 0;
+    if (column > 0) { nbytes += sizeof(Long); }
+    if (column > 1) { nbytes += sizeof(int); }
+    const int nreal = static_cast<int>(m_real_names.size());
+    nbytes += std::min(std::max(column-2, 0), nreal) * rsize;
+    nbytes += std::max(column-2-nreal, 0) * Long(sizeof(int));
+    return m_where[lev][grid] + nbytes*m_count[lev][grid];
+}
+
+namespace {
+    template <class T, class F>
+    void readColumn (const std::string& name, Long offset, Long n, Vector<T>& data, F&& read)
+    {
+        data.resize(n);
+        if (n == 0) { return; }
+        std::ifstream ifs(name, std::ios::in | std::ios::binary);
+        if (!ifs.good()) { amrex::FileOpenFailed(name); }
+        ifs.seekg(offset, std::ios::beg);
+        read(data.dataPtr(), std::size_t(n), ifs);
+        if (!ifs.good()) {
+            amrex::Abort("ColumnarParticleReader: problem reading " + name);
+        }
+    }
+}
+
+void
+ColumnarParticleReader::readIds (int lev, int grid, Vector<Long>& ids) const
+{
+    readColumn(fileName(lev,grid), columnOffset(lev,grid,0), m_count[lev][grid], ids,
+               [] (Long* p, std::size_t n, std::istream& is) { readData(p, n, is); });
+}
+
+void
+ColumnarParticleReader::readCpus (int lev, int grid, Vector<int>& cpus) const
+{
+    readColumn(fileName(lev,grid), columnOffset(lev,grid,1), m_count[lev][grid], cpus,
+               [] (int* p, std::size_t n, std::istream& is) { readData(p, n, is); });
+}
+
+void
+ColumnarParticleReader::readReal (int lev, int grid, int comp, Vector<ParticleReal>& data) const
+{
+    AMREX_ALWAYS_ASSERT(comp >= 0 && comp < static_cast<int>(m_real_names.size()));
+    const bool single = m_single;
+    readColumn(fileName(lev,grid), columnOffset(lev,grid,2+comp), m_count[lev][grid], data,
+               [=] (ParticleReal* p, std::size_t n, std::istream& is)
+               {
+                   if (single == std::is_same_v<ParticleReal,float>) {
+                       readData(p, n, is);
+                   } else if (single) {
+                       Vector<float> tmp(n);
+                       readData(tmp.dataPtr(), n, is);
+                       std::copy(tmp.begin(), tmp.end(), p);
+                   } else {
+                       Vector<double> tmp(n);
+                       readData(tmp.dataPtr(), n, is);
+                       std::copy(tmp.begin(), tmp.end(), p);
+                   }
+               });
+}
+
+void
+ColumnarParticleReader::readInt (int lev, int grid, int comp, Vector<int>& data) const
+{
+    AMREX_ALWAYS_ASSERT(comp >= 0 && comp < static_cast<int>(m_int_names.size()));
+    const int column = 2 + static_cast<int>(m_real_names.size()) + comp;
+    readColumn(fileName(lev,grid), columnOffset(lev,grid,column), m_count[lev][grid], data,
+               [] (int* p, std::size_t n, std::istream& is) { readData(p, n, is); });
+}
+
+}
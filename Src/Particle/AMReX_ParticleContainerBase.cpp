@@ -10,6 +10,8 @@ using namespace amrex;
 bool    ParticleContainerBase::do_tiling = false;
 IntVect ParticleContainerBase::tile_size { AMREX_D_DECL(1024000,8,8) };
 bool    ParticleContainerBase::memEfficientSort = true;
+bool    ParticleContainerBase::incrementalSort = false;
+Real    ParticleContainerBase::incrementalSortMaxFraction = Real(0.1);
 
 void ParticleContainerBase::Define (const Geometry            & geom,
                                     const DistributionMapping & dmap,
@@ -146,6 +148,19 @@ void ParticleContainerBase::SetParticleGeometry (int lev, Geometry new_geom) //
     m_gdb->SetParticleGeometry(lev, new_geom);
 }
 
+void ParticleContainerBase::MarkTileChanged (int lev, int grid, int tile)
+{
+    if (lev >= m_tile_change_stamps.size()) { m_tile_change_stamps.resize(lev+1); }
+    m_tile_change_stamps[lev][std::make_pair(grid, tile)] = ++m_tile_change_count;
+}
+
+Long ParticleContainerBase::TileChangeStamp (int lev, int grid, int tile) const
+{
+    if (lev >= m_tile_change_stamps.size()) { return 0; }
+    auto it = m_tile_change_stamps[lev].find(std::make_pair(grid, tile));
+    return (it != m_tile_change_stamps[lev].end()) ? it->second : 0;
+}
+
 const std::string& ParticleContainerBase::CheckpointVersion ()
 {
     //
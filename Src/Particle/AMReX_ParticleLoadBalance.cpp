@@ -0,0 +1,56 @@
+#include <AMReX_ParticleLoadBalance.H>
+#include <AMReX_ParallelDescriptor.H>
+
+#include <algorithm>
+
+namespace amrex
+{
+
+void
+ParticleMeshCostModel::calibrate (Real mesh_seconds, Long num_cells,
+                                  Real particle_seconds, Long num_particles)
+{
+    Real t[2] = {mesh_seconds, particle_seconds};
+    Long n[2] = {num_cells, num_particles};
+    ParallelDescriptor::ReduceRealSum(t, 2);
+    ParallelDescriptor::ReduceLongSum(n, 2);
+
+    if (n[0] > 0) { cell_cost = t[0] / static_cast<Real>(n[0]); }
+    if (n[1] > 0) { particle_cost = t[1] / static_cast<Real>(n[1]); }
+}
+
+Real
+LoadBalanceEfficiency (const Vector<Real>& cost, const DistributionMapping& dm)
+{
+    AMREX_ALWAYS_ASSERT(static_cast<Long>(cost.size()) == dm.size());
+
+    Vector<Real> rank_cost(ParallelDescriptor::NProcs(), 0.0_rt);
+    for (int i = 0; i < static_cast<int>(cost.size()); ++i) {
+        rank_cost[dm[i]] += cost[i];
+    }
+
+    Real sum = 0.0_rt;
+    Real max = 0.0_rt;
+    for (auto c : rank_cost) {
+        sum += c;
+        max = std::max(max, c);
+    }
+    return (max > 0.0_rt) ? sum / (static_cast<Real>(rank_cost.size()) * max) : 1.0_rt;
+}
+
+void
+RemapMultiFab (MultiFab& mf, const DistributionMapping& dm)
+{
+    BL_PROFILE("RemapMultiFab()");
+
+    if (mf.DistributionMap() == dm) { return; }
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!mf.hasEBFabFactory(),
+        "RemapMultiFab: MultiFabs with an EB factory are not supported");
+
+    MultiFab new_mf(mf.boxArray(), dm, mf.nComp(), mf.nGrowVect());
+    new_mf.Redistribute(mf, 0, 0, mf.nComp(), mf.nGrowVect());
+    mf = std::move(new_mf);
+}
+
+}
@@ -0,0 +1,100 @@
+#include <AMReX_Amr.H>
+#include <AMReX_AmrLevel.H>
+#include <AMReX_AsyncOut.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Utility.H>
+
+using namespace amrex;
+
+amrex::LevelBld* getLevelBld ();
+
+//
+// Run the UniformVelocity problem with amrex.async_out and amr.check_int, so
+// that the checkpoints are written in the background.  After Amr::finalize the
+// last checkpoint must have its final name, and a new Amr must restart from it
+// with the same state.
+//
+
+int
+main (int   argc,
+      char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    AMREX_ALWAYS_ASSERT(AsyncOut::UseAsyncOut());
+
+    int  max_step = -1;
+    Real stop_time = -1.0;
+    std::string check_file("chk");
+    {
+        ParmParse pp;
+        pp.get("max_step",max_step);
+        pp.query("stop_time",stop_time);
+
+        ParmParse ppa("amr");
+        ppa.query("check_file",check_file);
+    }
+
+    auto checkpointIsFinal = [] (std::string const& chkfile)
+    {
+        return amrex::FileExists(chkfile + "/Header") && !amrex::FileExists(chkfile + ".temp");
+    };
+
+    std::string chkfile;
+    int  nsteps = 0;
+    Real time = 0.0;
+    Real sum = 0.0;
+    {
+        Amr amr(getLevelBld());
+
+        amr.init(0.0,stop_time);
+
+        while (amr.levelSteps(0) < max_step) {
+            amr.coarseTimeStep(stop_time);
+        }
+
+        if (amr.stepOfLastCheckPoint() < amr.levelSteps(0)) {
+            amr.checkPoint();
+        }
+
+        amr.finalize();
+
+        nsteps = amr.levelSteps(0);
+        time = amr.cumTime();
+        sum = amr.getLevel(0).get_new_data(0).sum(0);
+
+        chkfile = amrex::Concatenate(check_file, nsteps, 5);
+        AMREX_ALWAYS_ASSERT(checkpointIsFinal(chkfile));
+        amrex::Print() << "Checkpoint " << chkfile << " was written\n";
+    }
+
+    {
+        ParmParse pp("amr");
+        pp.add("restart", chkfile);
+    }
+
+    {
+        Amr amr(getLevelBld());
+
+        amr.init(0.0,stop_time);
+
+        AMREX_ALWAYS_ASSERT(amr.levelSteps(0) == nsteps);
+        AMREX_ALWAYS_ASSERT(amr.cumTime() == time);
+        AMREX_ALWAYS_ASSERT(amr.getLevel(0).get_new_data(0).sum(0) == sum);
+        amrex::Print() << "Restarted from " << chkfile << "\n";
+
+        // and checkpoint again after the restart
+        while (amr.levelSteps(0) < nsteps+2) {
+            amr.coarseTimeStep(stop_time);
+        }
+
+        amr.finalize();
+
+        AMREX_ALWAYS_ASSERT(checkpointIsFinal(amrex::Concatenate(check_file, nsteps+2, 5)));
+    }
+
+    amrex::Finalize();
+
+    return 0;
+}
@@ -77,6 +77,8 @@ main (int   argc,
             amr.writePlotFile();
         }
 
+        amr.finalize();
+
     }
 
     auto dRunTime2 = amrex::second() - dRunTime1;
@@ -0,0 +1,122 @@
+#include <AMReX.H>
+#include <AMReX_Amr.H>
+#include <AMReX_Print.H>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace amrex;
+
+//
+// amr.subcycling_mode = CostAware feeds the measured cost per advance and the
+// dt estimate of each level into Amr::computeOptimalSubcycling.  Check the
+// pattern it picks on synthetic inputs against known answers and against an
+// independent search over all the valid patterns.
+//
+
+void testKnownPatterns ();
+void testAgainstSearch ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    testKnownPatterns();
+    testAgainstSearch();
+
+    amrex::Finalize();
+}
+
+//! Projected wall time per unit of simulated time for n_cycle
+Real projectedRate (const std::vector<int>& n_cycle, const std::vector<Real>& dt_max,
+                    const std::vector<Real>& cost)
+{
+    Real dt = dt_max[0];
+    Real work = cost[0];
+    int nsteps = 1;
+    for (int lev = 1; lev < int(n_cycle.size()); ++lev) {
+        nsteps *= n_cycle[lev];
+        dt = std::min(dt, static_cast<Real>(nsteps)*dt_max[lev]);
+        work += static_cast<Real>(nsteps)*cost[lev];
+    }
+    return work/dt;
+}
+
+//! Lowest projected rate over all n_cycle with 1 <= n_cycle[lev] <= cycle_max[lev]
+Real bestRate (std::vector<int>& n_cycle, int lev, const std::vector<Real>& dt_max,
+               const std::vector<Real>& cost, const std::vector<int>& cycle_max)
+{
+    if (lev == int(n_cycle.size())) {
+        return projectedRate(n_cycle, dt_max, cost);
+    }
+    Real best = std::numeric_limits<Real>::max();
+    for (int c = 1; c <= cycle_max[lev]; ++c) {
+        n_cycle[lev] = c;
+        best = std::min(best, bestRate(n_cycle, lev+1, dt_max, cost, cycle_max));
+    }
+    return best;
+}
+
+std::vector<int> optimalPattern (const std::vector<Real>& dt_max, const std::vector<Real>& cost,
+                                 const std::vector<int>& cycle_max)
+{
+    const int nlev = static_cast<int>(dt_max.size());
+    std::vector<int> best(nlev);
+    Amr::computeOptimalSubcycling(nlev, best.data(), dt_max.data(), cost.data(), cycle_max.data());
+    for (int lev = 1; lev < nlev; ++lev) {
+        AMREX_ALWAYS_ASSERT(best[lev] >= 1 && best[lev] <= cycle_max[lev]);
+    }
+    return best;
+}
+
+void testKnownPatterns ()
+{
+    const std::vector<int> cycle_max{1, 2, 2};
+
+    // the dt of each level is limited by its own CFL condition: subcycle everywhere
+    AMREX_ALWAYS_ASSERT((optimalPattern({1.0, 0.5, 0.25}, {1.0, 1.0, 1.0}, cycle_max)
+                         == std::vector<int>{1, 2, 2}));
+
+    // the fine levels can take the coarse dt: no subcycling
+    AMREX_ALWAYS_ASSERT((optimalPattern({1.0, 1.0, 1.0}, {1.0, 1.0, 1.0}, cycle_max)
+                         == std::vector<int>{1, 1, 1}));
+
+    // only level 1 is limited by the coarse dt
+    AMREX_ALWAYS_ASSERT((optimalPattern({1.0, 0.5, 0.5}, {1.0, 1.0, 1.0}, cycle_max)
+                         == std::vector<int>{1, 2, 1}));
+
+    amrex::Print() << "The known subcycling patterns match\n";
+}
+
+void testAgainstSearch ()
+{
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(0.1, 1.0);
+    std::uniform_int_distribution<int> ratio(0, 1);
+
+    const int ntests = 200;
+    for (int n = 0; n < ntests; ++n)
+    {
+        const int nlev = 2 + n%3;
+        std::vector<Real> dt_max(nlev), cost(nlev);
+        std::vector<int> cycle_max(nlev, 1);
+        for (int lev = 0; lev < nlev; ++lev) {
+            dt_max[lev] = static_cast<Real>(dist(gen));
+            cost[lev] = static_cast<Real>(dist(gen));
+            if (lev > 0) { cycle_max[lev] = 2 + 2*ratio(gen); }
+        }
+
+        const auto best = optimalPattern(dt_max, cost, cycle_max);
+
+        std::vector<int> n_cycle(nlev, 1);
+        const Real expected = bestRate(n_cycle, 1, dt_max, cost, cycle_max);
+        const Real got = projectedRate(best, dt_max, cost);
+        AMREX_ALWAYS_ASSERT(std::abs(got - expected) <= Real(1.e-5)*expected);
+    }
+
+    amrex::Print() << "The subcycling patterns of " << ntests
+                   << " random inputs are optimal\n";
+}
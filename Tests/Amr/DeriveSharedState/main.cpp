@@ -0,0 +1,255 @@
+#include <AMReX.H>
+#include <AMReX_Amr.H>
+#include <AMReX_AmrLevel.H>
+#include <AMReX_LevelBld.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_PlotFileUtil.H>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace amrex;
+
+//
+// Write the same two-level plotfile with amr.plot_derive_shared_state off and
+// on, and check that the two are identical.  The derived quantities read the
+// state components 2, 3 and 0, so that the shared state skips component 1,
+// and one of them needs a ghost cell.
+//
+
+enum StateType { State_Type = 0 };
+
+constexpr int NUM_STATE = 4;
+
+class DeriveLevel
+    :
+    public AmrLevel
+{
+public:
+
+    DeriveLevel () = default;
+
+    DeriveLevel (Amr& papa, int lev, const Geometry& level_geom, const BoxArray& bl,
+                 const DistributionMapping& dm, Real time)
+        : AmrLevel(papa, lev, level_geom, bl, dm, time) {}
+
+    static void variableSetUp ();
+
+    static void variableCleanUp () { desc_lst.clear(); derive_lst.clear(); }
+
+    void computeInitialDt (int finest_level, int /*sub_cycle*/, Vector<int>& n_cycle,
+                           const Vector<IntVect>& /*ref_ratio*/, Vector<Real>& dt_level,
+                           Real /*stop_time*/) override
+    {
+        for (int lev = 0; lev <= finest_level; ++lev) {
+            n_cycle[lev] = 1;
+            dt_level[lev] = 1.0;
+        }
+    }
+
+    void computeNewDt (int finest_level, int sub_cycle, Vector<int>& n_cycle,
+                       const Vector<IntVect>& ref_ratio, Vector<Real>& /*dt_min*/,
+                       Vector<Real>& dt_level, Real stop_time, int /*post_regrid_flag*/) override
+    {
+        computeInitialDt(finest_level, sub_cycle, n_cycle, ref_ratio, dt_level, stop_time);
+    }
+
+    Real advance (Real /*time*/, Real dt, int /*iteration*/, int /*ncycle*/) override
+    {
+        return dt;
+    }
+
+    void post_regrid (int /*lbase*/, int /*new_finest*/) override {}
+
+    void post_init (Real /*stop_time*/) override {}
+
+    void initData () override;
+
+    void init (AmrLevel& old) override
+    {
+        const Real cur_time = old.get_state_data(State_Type).curTime();
+        setTimeLevel(cur_time, 1.0, 1.0);
+        MultiFab& S_new = get_new_data(State_Type);
+        FillPatch(old, S_new, 0, cur_time, State_Type, 0, NUM_STATE);
+    }
+
+    void init () override
+    {
+        const Real cur_time = parent->getLevel(level-1).get_state_data(State_Type).curTime();
+        setTimeLevel(cur_time, 1.0, 1.0);
+        MultiFab& S_new = get_new_data(State_Type);
+        FillCoarsePatch(S_new, 0, cur_time, State_Type, 0, NUM_STATE);
+    }
+
+    void errorEst (TagBoxArray& tags, int /*clearval*/, int tagval, Real /*time*/,
+                   int /*n_error_buf*/, int /*ngrow*/) override;
+};
+
+//! Each state component varies smoothly, and differently, in space
+void
+DeriveLevel::initData ()
+{
+    const auto problo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    MultiFab& S_new = get_new_data(State_Type);
+    for (MFIter mfi(S_new); mfi.isValid(); ++mfi)
+    {
+        const auto& s = S_new.array(mfi);
+        amrex::ParallelFor(mfi.validbox(), NUM_STATE,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            AMREX_D_TERM(const Real x = problo[0] + (i+0.5_rt)*dx[0];,
+                         const Real y = problo[1] + (j+0.5_rt)*dx[1];,
+                         const Real z = problo[2] + (k+0.5_rt)*dx[2];)
+            s(i,j,k,n) = Real(n+1) * (AMREX_D_TERM(std::sin(Real(n+1)*x),
+                                                   + std::cos(y),
+                                                   + x*z));
+        });
+    }
+}
+
+//! Refine the middle of the domain
+void
+DeriveLevel::errorEst (TagBoxArray& tags, int /*clearval*/, int tagval, Real /*time*/,
+                       int /*n_error_buf*/, int /*ngrow*/)
+{
+    Box middle = geom.Domain();
+    middle.grow(-middle.length(0)/4);
+    for (MFIter mfi(tags); mfi.isValid(); ++mfi)
+    {
+        const auto& t = tags.array(mfi);
+        const auto tv = static_cast<char>(tagval);
+        amrex::ParallelFor(mfi.validbox() & middle,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            t(i,j,k) = tv;
+        });
+    }
+}
+
+//! All the boundaries are periodic
+void nullfill (Box const& /*bx*/, FArrayBox& /*data*/, int /*dcomp*/, int /*numcomp*/,
+               Geometry const& /*geom*/, Real /*time*/, const Vector<BCRec>& /*bcr*/,
+               int /*bcomp*/, int /*scomp*/)
+{}
+
+void
+DeriveLevel::variableSetUp ()
+{
+    desc_lst.addDescriptor(State_Type, IndexType::TheCellType(),
+                           StateDescriptor::Point, 1, NUM_STATE,
+                           &cell_cons_interp);
+
+    BCRec bc;
+    for (int i = 0; i < AMREX_SPACEDIM; ++i) {
+        bc.setLo(i, BCType::int_dir);
+        bc.setHi(i, BCType::int_dir);
+    }
+    StateDescriptor::BndryFunc bndryfunc(nullfill);
+    const char* names[NUM_STATE] = {"s0", "s1", "s2", "s3"};
+    for (int n = 0; n < NUM_STATE; ++n) {
+        desc_lst.setComponent(State_Type, n, names[n], bc, bndryfunc);
+    }
+
+    // a stencil on component 2
+    derive_lst.add("grad_s2", IndexType::TheCellType(), 1,
+        [] (const Box& bx, FArrayBox& derfab, int dcomp, int /*ncomp*/, const FArrayBox& datafab,
+            const Geometry& /*geomdata*/, Real /*time*/, const int* /*bcrec*/, int /*level*/)
+        {
+            const auto& d = derfab.array(dcomp);
+            const auto& s = datafab.const_array();
+            amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                d(i,j,k) = s(i+1,j,k) - s(i-1,j,k);
+            });
+        }, DeriveRec::GrowBoxByOne);
+    derive_lst.addComponent("grad_s2", desc_lst, State_Type, 2, 1);
+
+    // components 3 and 0, as two ranges
+    derive_lst.add("s3_s0", IndexType::TheCellType(), 2, {"s3_plus_s0", "s3_minus_s0"},
+        [] (const Box& bx, FArrayBox& derfab, int dcomp, int /*ncomp*/, const FArrayBox& datafab,
+            const Geometry& /*geomdata*/, Real /*time*/, const int* /*bcrec*/, int /*level*/)
+        {
+            const auto& d = derfab.array(dcomp);
+            const auto& s = datafab.const_array();
+            amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                d(i,j,k,0) = s(i,j,k,0) + Real(100.)*s(i,j,k,1);
+                d(i,j,k,1) = s(i,j,k,0) - s(i,j,k,1);
+            });
+        }, DeriveRec::TheSameBox);
+    derive_lst.addComponent("s3_s0", desc_lst, State_Type, 3, 1);
+    derive_lst.addComponent("s3_s0", desc_lst, State_Type, 0, 1);
+}
+
+class DeriveLevelBld
+    :
+    public LevelBld
+{
+    void variableSetUp () override { DeriveLevel::variableSetUp(); }
+    void variableCleanUp () override { DeriveLevel::variableCleanUp(); }
+    AmrLevel* operator() () override { return new DeriveLevel; }
+    AmrLevel* operator() (Amr& papa, int lev, const Geometry& level_geom, const BoxArray& ba,
+                          const DistributionMapping& dm, Real time) override
+    {
+        return new DeriveLevel(papa, lev, level_geom, ba, dm, time);
+    }
+};
+
+extern "C" {
+    void amrex_probinit (const int* /*init*/, const int* /*name*/, const int* /*namelen*/,
+                         const Real* /*problo*/, const Real* /*probhi*/) {}
+}
+
+//! Write the plotfile of the initial data with the given plot_derive_shared_state
+std::string writePlotFile (int shared_state)
+{
+    const std::string plot_file = shared_state ? "plt_shared" : "plt_separate";
+    {
+        ParmParse pp("amr");
+        pp.add("plot_derive_shared_state", shared_state);
+        pp.add("plot_file", plot_file);
+    }
+
+    DeriveLevelBld bld;
+    Amr amr(&bld);
+    amr.init(0.0, 1.0);
+    AMREX_ALWAYS_ASSERT(Amr::PlotDeriveSharedState() == bool(shared_state));
+    AMREX_ALWAYS_ASSERT(amr.finestLevel() == 1);
+    amr.writePlotFile();
+    amr.finalize();
+
+    return amrex::Concatenate(plot_file, 0, 5);
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        const std::string separate = writePlotFile(0);
+        const std::string shared = writePlotFile(1);
+
+        PlotFileData a(separate);
+        PlotFileData b(shared);
+        AMREX_ALWAYS_ASSERT(a.varNames() == b.varNames());
+        AMREX_ALWAYS_ASSERT(a.finestLevel() == b.finestLevel());
+
+        for (auto const& name : {"grad_s2", "s3_plus_s0", "s3_minus_s0"}) {
+            AMREX_ALWAYS_ASSERT(std::find(a.varNames().begin(), a.varNames().end(), name)
+                                != a.varNames().end());
+        }
+
+        for (int lev = 0; lev <= a.finestLevel(); ++lev) {
+            for (auto const& name : a.varNames()) {
+                MultiFab mfa = a.get(lev, name);
+                MultiFab mfb = b.get(lev, name);
+                AMREX_ALWAYS_ASSERT(mfb.norminf() > 0.0);
+                MultiFab::Subtract(mfa, mfb, 0, 0, 1, 0);
+                const Real diff = mfa.norminf();
+                amrex::Print() << "level " << lev << " " << name << ": max difference " << diff << "\n";
+                AMREX_ALWAYS_ASSERT(diff == 0.0);
+            }
+        }
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,145 @@
+#include <AMReX.H>
+#include <AMReX_Geometry.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Random.H>
+#include <AMReX_TagBox.H>
+
+#include <algorithm>
+
+using namespace amrex;
+
+//
+// Run the regridding operations on the same tags with TagBoxArray and with
+// SparseTagBoxArray, and check that both give the same tags at every step.
+//
+
+void testSparseTags ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    testSparseTags();
+
+    amrex::Finalize();
+}
+
+//! Number of cells, including ghost cells, where the tags of a and b differ.
+//! If exact is false, only whether a cell is tagged is compared.
+Long numDifferences (const TagBoxArray& a, const SparseTagBoxArray& sparse, bool exact)
+{
+    AMREX_ALWAYS_ASSERT(a.boxArray() == sparse.boxArray() && a.nGrowVect() == sparse.nGrowVect());
+
+    TagBoxArray b(sparse.boxArray(), sparse.DistributionMap(), sparse.nGrowVect());
+    sparse.copyTo(b);
+
+    Long ndiff = 0;
+    for (MFIter mfi(a); mfi.isValid(); ++mfi)
+    {
+        const auto& aa = a.const_array(mfi);
+        const auto& ba = b.const_array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), [&] (int i, int j, int k)
+        {
+            const bool same = exact ? (aa(i,j,k) == ba(i,j,k))
+                                    : ((aa(i,j,k) != TagBox::CLEAR) == (ba(i,j,k) != TagBox::CLEAR));
+            if (!same) { ++ndiff; }
+        });
+    }
+    ParallelDescriptor::ReduceLongSum(ndiff);
+    return ndiff;
+}
+
+void check (const std::string& step, const TagBoxArray& dense, const SparseTagBoxArray& sparse,
+            bool exact)
+{
+    const Long ndiff = numDifferences(dense, sparse, exact);
+    Long ntags = sparse.numLocalTags();
+    ParallelDescriptor::ReduceLongSum(ntags);
+    amrex::Print() << step << ": " << ntags << " tags, " << ndiff << " differences\n";
+    AMREX_ALWAYS_ASSERT(ndiff == 0);
+}
+
+void testSparseTags ()
+{
+    const Box domain(IntVect(0), IntVect(63));
+    RealBox real_box;
+    for (int n = 0; n < AMREX_SPACEDIM; n++) {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, 1.0);
+    }
+    // periodic in all but the last direction
+    Array<int,AMREX_SPACEDIM> is_per{AMREX_D_DECL(1, 1, 0)};
+    is_per[AMREX_SPACEDIM-1] = 0;
+    const Geometry geom(domain, real_box, CoordSys::cartesian, is_per);
+
+    BoxArray ba(domain);
+    ba.maxSize(16);
+    DistributionMapping dm(ba);
+
+    const IntVect ngrow(4);
+    const IntVect nbuf(AMREX_D_DECL(2, 3, 1));
+    const IntVect ratio(2);
+
+    TagBoxArray dense(ba, dm, ngrow);
+    dense.setVal(TagBox::CLEAR);
+
+    // SET and BUF tags in the valid region, clustered near the domain boundaries
+    amrex::InitRandom(1234 + ParallelDescriptor::MyProc());
+    for (MFIter mfi(dense); mfi.isValid(); ++mfi)
+    {
+        const auto& a = dense.array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k)
+        {
+            const IntVect iv(AMREX_D_DECL(i,j,k));
+            const bool near_boundary = !amrex::grow(domain, -4).contains(iv);
+            const Real r = amrex::Random();
+            if (r < (near_boundary ? 0.05 : 0.005)) {
+                a(i,j,k) = TagBox::SET;
+            } else if (r < (near_boundary ? 0.1 : 0.01)) {
+                a(i,j,k) = TagBox::BUF;
+            }
+        });
+    }
+
+    SparseTagBoxArray sparse(dense);
+    check("init", dense, sparse, true);
+
+    dense.buffer(nbuf);
+    sparse.buffer(nbuf);
+    check("buffer", dense, sparse, true);
+
+    const BoxArray notag(Box(IntVect(20), IntVect(40)));
+    dense.setVal(notag, TagBox::CLEAR);
+    sparse.setVal(notag, TagBox::CLEAR);
+    const BoxArray settag(Box(IntVect(44), IntVect(47)));
+    dense.setVal(settag, TagBox::BUF);
+    sparse.setVal(settag, TagBox::BUF);
+    check("setVal", dense, sparse, true);
+
+    dense.coarsen(ratio);
+    sparse.coarsen(ratio);
+    check("coarsen", dense, sparse, true);
+
+    // TagBoxArray adds the values of the periodic images, so only compare
+    // which cells are tagged.
+    const Geometry cgeom = amrex::coarsen(geom, ratio);
+    dense.mapPeriodicRemoveDuplicates(cgeom);
+    sparse.mapPeriodicRemoveDuplicates(cgeom);
+    check("mapPeriodicRemoveDuplicates", dense, sparse, false);
+
+    Gpu::PinnedVector<IntVect> dense_tags, sparse_tags;
+    dense.collate(dense_tags);
+    sparse.collate(sparse_tags);
+    if (ParallelDescriptor::IOProcessor())
+    {
+        std::sort(dense_tags.begin(), dense_tags.end());
+        std::sort(sparse_tags.begin(), sparse_tags.end());
+        amrex::Print() << "collate: " << dense_tags.size() << " dense and "
+                       << sparse_tags.size() << " sparse tags\n";
+        AMREX_ALWAYS_ASSERT(!dense_tags.empty());
+        AMREX_ALWAYS_ASSERT(std::equal(dense_tags.begin(), dense_tags.end(),
+                                       sparse_tags.begin(), sparse_tags.end()));
+    }
+
+    amrex::Print() << "pass\n";
+}
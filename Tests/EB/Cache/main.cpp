@@ -0,0 +1,148 @@
+#include <AMReX.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IndexSpace_chkpt_file.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_MultiCutFab.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Utility.H>
+
+#include <algorithm>
+#include <filesystem>
+
+using namespace amrex;
+
+//
+// Build the EB from the inputs with eb2.cache_dir set, build it again from
+// the cache, and check that both give the same EB data.  Then check that a
+// change in the geometry gives a new cache entry.
+//
+
+void testCache ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    testCache();
+
+    amrex::Finalize();
+}
+
+//! Number of cache entries, not counting partially written ones
+int numCacheEntries (const std::string& cache_dir)
+{
+    int n = 0;
+    if (ParallelDescriptor::IOProcessor()) {
+        for (auto const& entry : std::filesystem::directory_iterator(cache_dir)) {
+            if (entry.path().filename().string().find(".temp") == std::string::npos) { ++n; }
+        }
+    }
+    ParallelDescriptor::Bcast(&n, 1, ParallelDescriptor::IOProcessorNumber());
+    return n;
+}
+
+template <class FAB>
+Long numDifferences (const FabArray<FAB>& a, const FabArray<FAB>& b)
+{
+    Long ndiff = 0;
+    for (MFIter mfi(a); mfi.isValid(); ++mfi)
+    {
+        if (!a.defined(mfi) || !b.defined(mfi)) {
+            if (a.defined(mfi) != b.defined(mfi)) { ++ndiff; }
+            continue;
+        }
+        // CutFabs of regular and covered boxes are empty
+        const Box& bx = a[mfi].box();
+        if (bx != b[mfi].box()) {
+            ++ndiff;
+            continue;
+        }
+        auto const& aa = a.const_array(mfi);
+        auto const& ba = b.const_array(mfi);
+        amrex::LoopOnCpu(bx, a.nComp(), [&] (int i, int j, int k, int n)
+        {
+            if (!(aa(i,j,k,n) == ba(i,j,k,n))) { ++ndiff; }
+        });
+    }
+    ParallelDescriptor::ReduceLongSum(ndiff);
+    return ndiff;
+}
+
+Long numDifferences (const EBFArrayBoxFactory& a, const EBFArrayBoxFactory& b)
+{
+    Long ndiff = numDifferences(a.getMultiEBCellFlagFab(), b.getMultiEBCellFlagFab())
+        +        numDifferences(a.getVolFrac(), b.getVolFrac())
+        +        numDifferences(a.getCentroid().data(), b.getCentroid().data())
+        +        numDifferences(a.getBndryCent().data(), b.getBndryCent().data())
+        +        numDifferences(a.getBndryArea().data(), b.getBndryArea().data())
+        +        numDifferences(a.getBndryNormal().data(), b.getBndryNormal().data());
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        ndiff += numDifferences(a.getAreaFrac()[idim]->data(), b.getAreaFrac()[idim]->data())
+            +    numDifferences(a.getFaceCent()[idim]->data(), b.getFaceCent()[idim]->data());
+    }
+    return ndiff;
+}
+
+void testCache ()
+{
+    const Box domain(IntVect(0), IntVect(63));
+    RealBox real_box;
+    for (int n = 0; n < AMREX_SPACEDIM; n++) {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, 1.0);
+    }
+    const Geometry geom(domain, real_box, CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+
+    BoxArray ba(domain);
+    ba.maxSize(16);
+    DistributionMapping dm(ba);
+    const Vector<int> ngrow{4,3,2};
+
+    ParmParse pp("eb2");
+    std::string cache_dir;
+    pp.get("cache_dir", cache_dir);
+    amrex::UtilCreateCleanDirectory(cache_dir);
+
+    // Build the geometry and write the cache
+    EB2::Build(geom, 0, 2);
+    const EB2::IndexSpace* built_index_space = EB2::TopIndexSpace();
+    auto built = makeEBFabFactory(geom, ba, dm, ngrow, EBSupport::full);
+    AMREX_ALWAYS_ASSERT(numCacheEntries(cache_dir) == 1);
+
+    // Read the geometry from the cache
+    EB2::Build(geom, 0, 2);
+    AMREX_ALWAYS_ASSERT(dynamic_cast<EB2::IndexSpaceChkptFile const*>(EB2::TopIndexSpace()));
+    auto cached = makeEBFabFactory(geom, ba, dm, ngrow, EBSupport::full);
+    AMREX_ALWAYS_ASSERT(numCacheEntries(cache_dir) == 1);
+
+    const Long ndiff = numDifferences(*built, *cached);
+    amrex::Print() << "Cached EB data: " << ndiff << " differences\n";
+    AMREX_ALWAYS_ASSERT(ndiff == 0);
+
+    // The coarse levels are made by coarsening the cached level
+    const Geometry cgeom = amrex::coarsen(geom, 4);
+    const BoxArray cba = amrex::coarsen(ba, 4);
+    auto cbuilt = makeEBFabFactory(built_index_space, cgeom, cba, dm,
+                                   ngrow, EBSupport::full);
+    auto ccached = makeEBFabFactory(EB2::TopIndexSpace(), cgeom, cba, dm,
+                                    ngrow, EBSupport::full);
+    const Long ncdiff = numDifferences(*cbuilt, *ccached);
+    amrex::Print() << "Coarsened EB data: " << ncdiff << " differences\n";
+    AMREX_ALWAYS_ASSERT(ncdiff == 0);
+
+    // A different geometry gets a different cache entry
+    pp.add("sphere_radius", 0.3_rt);
+    EB2::Build(geom, 0, 2);
+    AMREX_ALWAYS_ASSERT(dynamic_cast<EB2::IndexSpaceChkptFile const*>(EB2::TopIndexSpace()) == nullptr);
+    AMREX_ALWAYS_ASSERT(numCacheEntries(cache_dir) == 2);
+
+    // The cache key does not use the eb2.* inputs the geometry does not read
+    const auto unused = ParmParse::getUnusedInputs("eb2");
+    for (auto const& s : unused) {
+        amrex::Print() << "Unused: " << s << "\n";
+    }
+    AMREX_ALWAYS_ASSERT(unused.size() == 1 && unused[0].find("eb2.sphere_radus") == 0);
+
+    amrex::Print() << "pass\n";
+}
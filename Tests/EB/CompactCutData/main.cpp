@@ -0,0 +1,192 @@
+#include <AMReX.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_MultiCutFab.H>
+#include <AMReX_MultiSparseCutFab.H>
+#include <AMReX_ParallelDescriptor.H>
+
+#include <string>
+
+using namespace amrex;
+
+//
+// Build the EB data of a sphere with and without eb2.compact_cut_data,
+// and check that the sparse and the dense forms of the volume, boundary,
+// face and edge data agree exactly in both cases.  Also check that the
+// compact factory allocates the dense data only while they are used.
+//
+
+void testCompactCutData ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    testCompactCutData();
+
+    amrex::Finalize();
+}
+
+//! Number of points of the fab boxes of b where a and b differ
+Long numDifferences (const MultiSparseCutFab& a, const MultiFab& b)
+{
+    Long ndiff = 0;
+    for (MFIter mfi(b); mfi.isValid(); ++mfi)
+    {
+        auto const& aa = a.const_array(mfi);
+        auto const& ba = b.const_array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), b.nComp(), [&] (int i, int j, int k, int n)
+        {
+            if (aa(i,j,k,n) != ba(i,j,k,n)) { ++ndiff; }
+        });
+    }
+    ParallelDescriptor::ReduceLongSum(ndiff);
+    return ndiff;
+}
+
+//! Number of points of the cut boxes of b where a and b differ
+Long numDifferences (const MultiSparseCutFab& a, const MultiCutFab& b)
+{
+    Long ndiff = 0;
+    for (MFIter mfi(b.data()); mfi.isValid(); ++mfi)
+    {
+        if (!b.ok(mfi)) { continue; }
+        auto const& aa = a.const_array(mfi);
+        auto const& ba = b.const_array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), b.nComp(), [&] (int i, int j, int k, int n)
+        {
+            if (aa(i,j,k,n) != ba(i,j,k,n)) { ++ndiff; }
+        });
+    }
+    ParallelDescriptor::ReduceLongSum(ndiff);
+    return ndiff;
+}
+
+//! Fab memory in bytes on all processes
+Long fabBytes ()
+{
+    Long r = amrex::TotalBytesAllocatedInFabs();
+    ParallelDescriptor::ReduceLongSum(r);
+    return r;
+}
+
+//! Check both forms of the data of the dense and the compact factory
+template <class MF>
+void check (const std::string& name, const MultiSparseCutFab& dense_sparse, const MF& dense,
+            const MultiSparseCutFab& compact_sparse, const MF& compact_dense)
+{
+    Long dense_bytes = dense_sparse.nBytes();
+    Long compact_bytes = compact_sparse.nBytes();
+    ParallelDescriptor::ReduceLongSum({dense_bytes, compact_bytes});
+    const Long ndiff = numDifferences(dense_sparse, dense)
+        +              numDifferences(compact_sparse, dense)
+        +              numDifferences(compact_sparse, compact_dense);
+    amrex::Print() << name << ": " << compact_bytes << " bytes, "
+                   << ndiff << " differences\n";
+    AMREX_ALWAYS_ASSERT(compact_bytes > 0 && compact_bytes == dense_bytes && ndiff == 0);
+}
+
+//! Same for the data on the faces or edges of each direction
+void check (const std::string& name, Array<const MultiSparseCutFab*,AMREX_SPACEDIM> dense_sparse,
+            Array<const MultiCutFab*,AMREX_SPACEDIM> dense,
+            Array<const MultiSparseCutFab*,AMREX_SPACEDIM> compact_sparse,
+            Array<const MultiCutFab*,AMREX_SPACEDIM> compact_dense)
+{
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        check(name + std::to_string(idim), *dense_sparse[idim], *dense[idim],
+              *compact_sparse[idim], *compact_dense[idim]);
+    }
+}
+
+//! Bytes of the sparse data of all processes
+Long sparseBytes (const EBFArrayBoxFactory& factory)
+{
+    Long r = factory.getSparseVolFrac().nBytes()
+        +    factory.getSparseCentroid().nBytes()
+        +    factory.getSparseBndryCent().nBytes()
+        +    factory.getSparseBndryArea().nBytes()
+        +    factory.getSparseBndryNormal().nBytes();
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        r += factory.getSparseAreaFrac()[idim]->nBytes()
+            + factory.getSparseFaceCent()[idim]->nBytes()
+            + factory.getSparseEdgeCent()[idim]->nBytes();
+    }
+    ParallelDescriptor::ReduceLongSum(r);
+    return r;
+}
+
+void testCompactCutData ()
+{
+    const Box domain(IntVect(0), IntVect(63));
+    RealBox real_box;
+    for (int n = 0; n < AMREX_SPACEDIM; n++) {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, 1.0);
+    }
+    const Geometry geom(domain, real_box, CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+
+    EB2::SphereIF sphere(0.3, {AMREX_D_DECL(0.51, 0.48, 0.5)}, false);
+    auto gshop = EB2::makeShop(sphere);
+    EB2::Build(gshop, geom, 0, 0);
+
+    BoxArray ba(domain);
+    ba.maxSize(16);
+    DistributionMapping dm(ba);
+    const Vector<int> ngrow{4,3,2};
+
+    const Long bytes_before = fabBytes();
+    EB2::compact_cut_data = false;
+    auto dense = makeEBFabFactory(geom, ba, dm, ngrow, EBSupport::full);
+    const Long dense_fab_bytes = fabBytes() - bytes_before;
+    EB2::compact_cut_data = true;
+    auto compact = makeEBFabFactory(geom, ba, dm, ngrow, EBSupport::full);
+    EB2::compact_cut_data = false;
+    const Long compact_fab_bytes = fabBytes() - bytes_before - dense_fab_bytes;
+
+    // Only the cell flags and the level set are dense in the compact factory.
+    const Long compact_bytes = compact_fab_bytes + sparseBytes(*compact);
+    amrex::Print() << "dense factory: " << dense_fab_bytes << " bytes, compact factory: "
+                   << compact_bytes << " bytes\n";
+    AMREX_ALWAYS_ASSERT(compact_bytes < dense_fab_bytes);
+
+    // The dense data of the compact factory are made from its sparse data.
+    check("volfrac", dense->getSparseVolFrac(), dense->getVolFrac(),
+          compact->getSparseVolFrac(), compact->getVolFrac());
+    check("centroid", dense->getSparseCentroid(), dense->getCentroid(),
+          compact->getSparseCentroid(), compact->getCentroid());
+    check("bndrycent", dense->getSparseBndryCent(), dense->getBndryCent(),
+          compact->getSparseBndryCent(), compact->getBndryCent());
+    check("bndryarea", dense->getSparseBndryArea(), dense->getBndryArea(),
+          compact->getSparseBndryArea(), compact->getBndryArea());
+    check("bndrynorm", dense->getSparseBndryNormal(), dense->getBndryNormal(),
+          compact->getSparseBndryNormal(), compact->getBndryNormal());
+    check("areafrac", dense->getSparseAreaFrac(), dense->getAreaFrac(),
+          compact->getSparseAreaFrac(), compact->getAreaFrac());
+    check("facecent", dense->getSparseFaceCent(), dense->getFaceCent(),
+          compact->getSparseFaceCent(), compact->getFaceCent());
+    check("edgecent", dense->getSparseEdgeCent(), dense->getEdgeCent(),
+          compact->getSparseEdgeCent(), compact->getEdgeCent());
+
+    // The getters above made the dense data of the compact factory.
+    const Long used_fab_bytes = fabBytes() - bytes_before - dense_fab_bytes;
+    amrex::Print() << "compact factory after the getters: " << used_fab_bytes
+                   << " fab bytes\n";
+    AMREX_ALWAYS_ASSERT(used_fab_bytes > compact_fab_bytes);
+
+    compact->releaseDenseData();
+    const Long released_fab_bytes = fabBytes() - bytes_before - dense_fab_bytes;
+    amrex::Print() << "compact factory after releaseDenseData: " << released_fab_bytes
+                   << " fab bytes\n";
+    AMREX_ALWAYS_ASSERT(released_fab_bytes == compact_fab_bytes);
+
+    // and makes them again on the next use
+    AMREX_ALWAYS_ASSERT(numDifferences(compact->getSparseVolFrac(), compact->getVolFrac()) == 0);
+    compact->releaseDenseData();
+
+    // releaseDenseData does nothing to the dense factory
+    dense->releaseDenseData();
+    AMREX_ALWAYS_ASSERT(fabBytes() - bytes_before == dense_fab_bytes + compact_fab_bytes);
+
+    amrex::Print() << "pass\n";
+}
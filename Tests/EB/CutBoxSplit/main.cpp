@@ -0,0 +1,117 @@
+#include <AMReX.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_MultiCutFab.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+
+using namespace amrex;
+
+//
+// Build the EB from the inputs without and with eb2.cut_boxes_per_proc, and
+// check that splitting the cut boxes gives the same EB data on the finest
+// and on the coarse EB levels.
+//
+
+void testCutBoxSplit ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    testCutBoxSplit();
+
+    amrex::Finalize();
+}
+
+template <class T>
+bool isSame (T a, T b) { return a == b; }
+
+//! Covered cells only differ in the bits of the neighbors, which are not
+//! used.  Those in covered boxes are connected to themselves, but not those
+//! in cut boxes, and splitting turns parts of cut boxes into covered boxes.
+bool isSame (EBCellFlag a, EBCellFlag b)
+{
+    return (a.isCovered() && b.isCovered()) || a == b;
+}
+
+template <class FAB>
+Long numDifferences (const FabArray<FAB>& a, const FabArray<FAB>& b)
+{
+    Long ndiff = 0;
+    for (MFIter mfi(a); mfi.isValid(); ++mfi)
+    {
+        // CutFabs of regular and covered boxes are empty
+        const Box& bx = a[mfi].box();
+        if (bx != b[mfi].box()) {
+            ++ndiff;
+            continue;
+        }
+        auto const& aa = a.const_array(mfi);
+        auto const& ba = b.const_array(mfi);
+        amrex::LoopOnCpu(bx, a.nComp(), [&] (int i, int j, int k, int n)
+        {
+            if (!isSame(aa(i,j,k,n), ba(i,j,k,n))) { ++ndiff; }
+        });
+    }
+    ParallelDescriptor::ReduceLongSum(ndiff);
+    return ndiff;
+}
+
+Long numDifferences (const EBFArrayBoxFactory& a, const EBFArrayBoxFactory& b)
+{
+    Long ndiff = numDifferences(a.getMultiEBCellFlagFab(), b.getMultiEBCellFlagFab())
+        +        numDifferences(a.getVolFrac(), b.getVolFrac())
+        +        numDifferences(a.getCentroid().data(), b.getCentroid().data())
+        +        numDifferences(a.getBndryCent().data(), b.getBndryCent().data())
+        +        numDifferences(a.getBndryArea().data(), b.getBndryArea().data())
+        +        numDifferences(a.getBndryNormal().data(), b.getBndryNormal().data());
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        ndiff += numDifferences(a.getAreaFrac()[idim]->data(), b.getAreaFrac()[idim]->data())
+            +    numDifferences(a.getFaceCent()[idim]->data(), b.getFaceCent()[idim]->data());
+    }
+    return ndiff;
+}
+
+void testCutBoxSplit ()
+{
+    const Box domain(IntVect(0), IntVect(63));
+    RealBox real_box;
+    for (int n = 0; n < AMREX_SPACEDIM; n++) {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, 1.0);
+    }
+    const Geometry geom(domain, real_box, CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+
+    const int max_coarsening_level = 2;
+    const Vector<int> ngrow{4,3,2};
+
+    int cut_boxes_per_proc = 0;
+    ParmParse().get("cut_boxes_per_proc", cut_boxes_per_proc);
+
+    // The existing path
+    EB2::Build(geom, 0, max_coarsening_level);
+    const EB2::IndexSpace* unsplit = EB2::TopIndexSpace();
+
+    // The cut boxes split until there are cut_boxes_per_proc per process
+    ParmParse("eb2").add("cut_boxes_per_proc", cut_boxes_per_proc);
+    EB2::Build(geom, 0, max_coarsening_level);
+    const EB2::IndexSpace* split = EB2::TopIndexSpace();
+    AMREX_ALWAYS_ASSERT(split != unsplit);
+
+    for (int ilev = 0; ilev <= max_coarsening_level; ++ilev)
+    {
+        const Geometry lgeom = amrex::coarsen(geom, 1 << ilev);
+        BoxArray ba(lgeom.Domain());
+        ba.maxSize(16 >> ilev);
+        DistributionMapping dm(ba);
+
+        auto a = makeEBFabFactory(unsplit, lgeom, ba, dm, ngrow, EBSupport::full);
+        auto b = makeEBFabFactory(split, lgeom, ba, dm, ngrow, EBSupport::full);
+        const Long ndiff = numDifferences(*a, *b);
+        amrex::Print() << "EB level " << ilev << ": " << ndiff << " differences\n";
+        AMREX_ALWAYS_ASSERT(ndiff == 0);
+    }
+
+    amrex::Print() << "pass\n";
+}
@@ -0,0 +1,310 @@
+#include <AMReX.H>
+#include <AMReX_EB_STL_utils.H>
+#include <AMReX_Geometry.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParallelDescriptor.H>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+using namespace amrex;
+
+//
+// Check the BVH accelerated queries of STLtools against brute force loops
+// over all the triangles of the surface, and the signed distance against
+// the exact one of a sphere, also with a hole cut into the sphere.
+//
+
+void testBVH ();
+void testSphere (bool with_hole);
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    testBVH();
+    testSphere(false);
+    testSphere(true);
+
+    amrex::Finalize();
+}
+
+using Triangle = STLtools::Triangle;
+
+//! Torus with major radius R and minor radius r around the z-axis, with the
+//! normals pointing out of the tube.
+Vector<Triangle> makeTorus (Real R, Real r, XDim3 const& c, int nu, int nv)
+{
+    auto pos = [&] (int i, int j) {
+        Real u = Real(2.)*Math::pi<Real>()*Real(i)/Real(nu);
+        Real v = Real(2.)*Math::pi<Real>()*Real(j)/Real(nv);
+        return XDim3{c.x + (R+r*std::cos(v))*std::cos(u),
+                     c.y + (R+r*std::cos(v))*std::sin(u),
+                     c.z + r*std::sin(v)};
+    };
+    Vector<Triangle> tris;
+    for (int i = 0; i < nu; ++i) {
+        for (int j = 0; j < nv; ++j) {
+            XDim3 p00 = pos(i,j), p10 = pos(i+1,j), p11 = pos(i+1,j+1), p01 = pos(i,j+1);
+            tris.push_back(Triangle{p00, p10, p11});
+            tris.push_back(Triangle{p00, p11, p01});
+        }
+    }
+    return tris;
+}
+
+//! Sphere of radius R made by refining an icosahedron nref times, with the
+//! normals pointing out.
+Vector<Triangle> makeSphere (Real R, XDim3 const& c, int nref)
+{
+    const Real t = (Real(1.) + std::sqrt(Real(5.))) / Real(2.);
+    const Vector<XDim3> v{{-1, t, 0}, { 1, t, 0}, {-1,-t, 0}, { 1,-t, 0},
+                          { 0,-1, t}, { 0, 1, t}, { 0,-1,-t}, { 0, 1,-t},
+                          { t, 0,-1}, { t, 0, 1}, {-t, 0,-1}, {-t, 0, 1}};
+    const int f[20][3] = {{0,11,5}, {0,5,1}, {0,1,7}, {0,7,10}, {0,10,11},
+                          {1,5,9}, {5,11,4}, {11,10,2}, {10,7,6}, {7,1,8},
+                          {3,9,4}, {3,4,2}, {3,2,6}, {3,6,8}, {3,8,9},
+                          {4,9,5}, {2,4,11}, {6,2,10}, {8,6,7}, {9,8,1}};
+    auto project = [&] (XDim3 const& q) {
+        Real s = R / std::sqrt(q.x*q.x + q.y*q.y + q.z*q.z);
+        return XDim3{q.x*s, q.y*s, q.z*s};
+    };
+    auto mid = [&] (XDim3 const& a, XDim3 const& b) {
+        return project(XDim3{a.x+b.x, a.y+b.y, a.z+b.z});
+    };
+    Vector<Triangle> tris;
+    for (auto const& fi : f) {
+        tris.push_back(Triangle{project(v[fi[0]]), project(v[fi[1]]), project(v[fi[2]])});
+    }
+    for (int n = 0; n < nref; ++n) {
+        Vector<Triangle> fine;
+        for (auto const& tr : tris) {
+            XDim3 a = mid(tr.v1,tr.v2), b = mid(tr.v2,tr.v3), d = mid(tr.v3,tr.v1);
+            fine.push_back(Triangle{tr.v1, a, d});
+            fine.push_back(Triangle{tr.v2, b, a});
+            fine.push_back(Triangle{tr.v3, d, b});
+            fine.push_back(Triangle{a, b, d});
+        }
+        std::swap(tris, fine);
+    }
+    for (auto& tr : tris) {
+        tr.v1 = XDim3{tr.v1.x+c.x, tr.v1.y+c.y, tr.v1.z+c.z};
+        tr.v2 = XDim3{tr.v2.x+c.x, tr.v2.y+c.y, tr.v2.z+c.z};
+        tr.v3 = XDim3{tr.v3.x+c.x, tr.v3.y+c.y, tr.v3.z+c.z};
+    }
+    return tris;
+}
+
+void writeSTL (std::string const& fname, Vector<Triangle> const& tris)
+{
+    if (ParallelDescriptor::IOProcessor()) {
+        std::ofstream ofs(fname);
+        ofs << std::setprecision(17) << "solid test\n";
+        for (auto const& t : tris) {
+            ofs << "facet normal 0 0 0\n"
+                << "outer loop\n"
+                << "vertex " << t.v1.x << " " << t.v1.y << " " << t.v1.z << "\n"
+                << "vertex " << t.v2.x << " " << t.v2.y << " " << t.v2.z << "\n"
+                << "vertex " << t.v3.x << " " << t.v3.y << " " << t.v3.z << "\n"
+                << "endloop\n"
+                << "endfacet\n";
+        }
+        ofs << "endsolid test\n";
+    }
+    ParallelDescriptor::Barrier();
+}
+
+Real dot (XDim3 const& a, XDim3 const& b) { return a.x*b.x + a.y*b.y + a.z*b.z; }
+XDim3 sub (XDim3 const& a, XDim3 const& b) { return XDim3{a.x-b.x, a.y-b.y, a.z-b.z}; }
+XDim3 cross (XDim3 const& a, XDim3 const& b)
+{
+    return XDim3{a.y*b.z-a.z*b.y, a.z*b.x-a.x*b.z, a.x*b.y-a.y*b.x};
+}
+
+//! Distance between p and triangle t, from the closest point on the plane,
+//! on the edges and on the vertices of the triangle.
+Real distance (XDim3 const& p, Triangle const& t)
+{
+    auto seg_dist2 = [&] (XDim3 const& a, XDim3 const& b) {
+        XDim3 ab = sub(b,a);
+        Real s = std::clamp(dot(sub(p,a),ab)/dot(ab,ab), Real(0.), Real(1.));
+        XDim3 q = sub(p, XDim3{a.x+s*ab.x, a.y+s*ab.y, a.z+s*ab.z});
+        return dot(q,q);
+    };
+    Real d2 = std::min({seg_dist2(t.v1,t.v2), seg_dist2(t.v2,t.v3), seg_dist2(t.v3,t.v1)});
+    XDim3 n = cross(sub(t.v2,t.v1), sub(t.v3,t.v1));
+    Real h = dot(sub(p,t.v1),n) / dot(n,n);
+    XDim3 q = sub(p, XDim3{h*n.x, h*n.y, h*n.z});
+    if (dot(cross(sub(t.v2,t.v1),sub(q,t.v1)),n) >= 0 &&
+        dot(cross(sub(t.v3,t.v2),sub(q,t.v2)),n) >= 0 &&
+        dot(cross(sub(t.v1,t.v3),sub(q,t.v3)),n) >= 0)
+    {
+        d2 = std::min(d2, h*h*dot(n,n));
+    }
+    return std::sqrt(d2);
+}
+
+//! Solid angle of triangle t seen from p, divided by 4 pi.
+Real windingNumber (XDim3 const& p, Triangle const& t)
+{
+    XDim3 a = sub(t.v1,p), b = sub(t.v2,p), c = sub(t.v3,p);
+    Real la = std::sqrt(dot(a,a)), lb = std::sqrt(dot(b,b)), lc = std::sqrt(dot(c,c));
+    Real num = dot(a,cross(b,c));
+    Real den = la*lb*lc + dot(a,b)*lc + dot(b,c)*la + dot(c,a)*lb;
+    return std::atan2(num,den) / (Real(2.)*Math::pi<Real>());
+}
+
+void testBVH ()
+{
+    const Real R = 0.5, r = 0.2;
+    const XDim3 center{0.03, -0.02, 0.01};
+    const auto tris = makeTorus(R, r, center, 48, 24);
+    writeSTL("torus.stl", tris);
+
+    STLtools stl;
+    stl.read_stl_file("torus.stl", 1.0, {0.0,0.0,0.0}, 0);
+
+    const Box domain(IntVect(0), IntVect(31));
+    const RealBox real_box({-1.,-1.,-1.}, {1.,1.,1.});
+    const Geometry geom(domain, real_box, CoordSys::cartesian, {0,0,0});
+    BoxArray ba(domain);
+    ba.maxSize(16);
+    ba.surroundingNodes();
+    DistributionMapping dm(ba);
+
+    const Real narrow_band = 0.15;
+    MultiFab inside(ba, dm, 1, 0);
+    MultiFab sdist(ba, dm, 1, 0);
+    stl.fill(inside, IntVect(0), geom, -1._rt, 1._rt);
+    stl.fillSignedDistance(sdist, IntVect(0), geom, narrow_band);
+
+    const auto plo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    Long npoints = 0, ninside = 0, nnear = 0, nwrong_inside = 0, nwrong_dist = 0;
+    for (MFIter mfi(inside); mfi.isValid(); ++mfi)
+    {
+        auto const& ia = inside.const_array(mfi);
+        auto const& sa = sdist.const_array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k)
+        {
+            const XDim3 p{plo[0]+i*dx[0], plo[1]+j*dx[1], plo[2]+k*dx[2]};
+            Real d = std::numeric_limits<Real>::max();
+            Real w = 0.;
+            for (auto const& t : tris) {
+                d = std::min(d, distance(p,t));
+                w += windingNumber(p,t);
+            }
+            ++npoints;
+            if (d < Real(1.e-10)) { return; } // on the surface
+            const bool in = w > Real(0.5);
+            if (in) { ++ninside; }
+            if (d < narrow_band) { ++nnear; }
+            if ((ia(i,j,k) > 0.) != in) { ++nwrong_inside; }
+            const Real sd = (in ? 1. : -1.) * std::min(d, narrow_band);
+            if (std::abs(sa(i,j,k) - sd) > Real(1.e-12)) { ++nwrong_dist; }
+        });
+    }
+    ParallelDescriptor::ReduceLongSum({npoints, ninside, nnear, nwrong_inside, nwrong_dist});
+
+    amrex::Print() << "BVH: " << npoints << " points, " << ninside << " inside, "
+                   << nnear << " near the surface\n"
+                   << "    inside/outside differences: " << nwrong_inside << "\n"
+                   << "    distance differences: " << nwrong_dist << "\n";
+    AMREX_ALWAYS_ASSERT(ninside > 0 && nnear > 0);
+    AMREX_ALWAYS_ASSERT(nwrong_inside == 0 && nwrong_dist == 0);
+
+}
+
+void testSphere (bool with_hole)
+{
+    const Real R = 0.5;
+    const XDim3 center{0.03, -0.02, 0.01};
+    auto tris = makeSphere(R, center, 4);
+
+    // The polyhedron is inside the sphere and touches it at the vertices,
+    // so its distance differs from the sphere's by at most the largest gap
+    // between the faces and the sphere.
+    Real tol = 0.;
+    for (auto const& t : tris) {
+        XDim3 n = cross(sub(t.v2,t.v1), sub(t.v3,t.v1));
+        tol = std::max(tol, R - std::abs(dot(sub(t.v1,center),n))/std::sqrt(dot(n,n)));
+    }
+
+    // Cut a ring shaped hole around the first triangle.  STLtools puts the
+    // reference point of its rays next to the first triangle, so many of
+    // the rays go through the hole and would get the parity wrong.  The
+    // points that see the hole under a large angle are not checked.
+    const Triangle t0 = tris[0];
+    XDim3 hole = sub(XDim3{(t0.v1.x+t0.v2.x+t0.v3.x)/3, (t0.v1.y+t0.v2.y+t0.v3.y)/3,
+                           (t0.v1.z+t0.v2.z+t0.v3.z)/3}, center);
+    Real s = R / std::sqrt(dot(hole,hole));
+    hole = XDim3{center.x + s*hole.x, center.y + s*hole.y, center.z + s*hole.z};
+    const Real hole_radius = 0.1;
+    if (with_hole) {
+        tris.erase(std::remove_if(tris.begin()+1, tris.end(), [&] (Triangle const& t) {
+                                      XDim3 d = sub(t.v1,hole);
+                                      return dot(d,d) < hole_radius*hole_radius;
+                                  }),
+                   tris.end());
+    }
+    writeSTL("sphere.stl", tris);
+
+    STLtools stl;
+    stl.read_stl_file("sphere.stl", 1.0, {0.0,0.0,0.0}, 0);
+
+    const Box domain(IntVect(0), IntVect(63));
+    const RealBox real_box({-1.,-1.,-1.}, {1.,1.,1.});
+    const Geometry geom(domain, real_box, CoordSys::cartesian, {0,0,0});
+    BoxArray ba(domain);
+    ba.maxSize(32);
+    ba.surroundingNodes();
+    DistributionMapping dm(ba);
+
+    const Real narrow_band = 0.2;
+    MultiFab sdist(ba, dm, 1, 0);
+    stl.fillSignedDistance(sdist, IntVect(0), geom, narrow_band);
+
+    const auto plo = geom.ProbLoArray();
+    const auto dx = geom.CellSizeArray();
+    Long npoints = 0, nwrong_sign = 0;
+    Real max_error = 0.;
+    for (MFIter mfi(sdist); mfi.isValid(); ++mfi)
+    {
+        auto const& sa = sdist.const_array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k)
+        {
+            const XDim3 p{plo[0]+i*dx[0], plo[1]+j*dx[1], plo[2]+k*dx[2]};
+            const Real exact = R - std::sqrt(dot(sub(p,center),sub(p,center)));
+            if (with_hole) {
+                if (std::abs(exact) < tol ||
+                    std::sqrt(dot(sub(p,hole),sub(p,hole))) < Real(3.)*hole_radius) {
+                    return;
+                }
+                ++npoints;
+                if ((sa(i,j,k) > 0.) != (exact > 0.)) { ++nwrong_sign; }
+            } else {
+                ++npoints;
+                const Real e = std::clamp(exact, -narrow_band, narrow_band);
+                max_error = std::max(max_error, std::abs(sa(i,j,k) - e));
+                if (std::abs(exact) > tol && (sa(i,j,k) > 0.) != (exact > 0.)) {
+                    ++nwrong_sign;
+                }
+            }
+        });
+    }
+    ParallelDescriptor::ReduceLongSum({npoints, nwrong_sign});
+    ParallelDescriptor::ReduceRealMax(max_error);
+
+    amrex::Print() << "Sphere" << (with_hole ? " with a hole: " : ": ") << tris.size()
+                   << " triangles, " << npoints << " points\n"
+                   << "    sign differences: " << nwrong_sign << "\n";
+    AMREX_ALWAYS_ASSERT(npoints > 0 && nwrong_sign == 0);
+    if (!with_hole) {
+        amrex::Print() << "    max distance error: " << max_error
+                       << ", faceting tolerance: " << tol << "\n";
+        AMREX_ALWAYS_ASSERT(max_error <= tol + Real(1.e-12));
+    } else {
+        amrex::Print() << "pass\n";
+    }
+}
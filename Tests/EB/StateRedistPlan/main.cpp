@@ -0,0 +1,154 @@
+#include <AMReX.H>
+#include <AMReX_BCRec.H>
+#include <AMReX_EB2.H>
+#include <AMReX_EB_Redistribution.H>
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Random.H>
+
+using namespace amrex;
+
+//
+// Redistribute random updates with state redistribution, once with the
+// geometric data computed on every call and once with a StateRedistPlan,
+// and check that both give the same result.
+//
+
+void testStateRedistPlan ();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    testStateRedistPlan();
+
+    amrex::Finalize();
+}
+
+void testStateRedistPlan ()
+{
+    const Box domain(IntVect(0), IntVect(63));
+    RealBox real_box;
+    for (int n = 0; n < AMREX_SPACEDIM; n++) {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, 1.0);
+    }
+    const Geometry geom(domain, real_box, CoordSys::cartesian, {AMREX_D_DECL(0,0,0)});
+
+    EB2::Build(geom, 0, 0);
+
+    // Small boxes, so that some of them have no cut cells in their ghost cells
+    BoxArray ba(domain);
+    ba.maxSize(8);
+    DistributionMapping dm(ba);
+    const int ng_eb = 6;
+    auto factory = makeEBFabFactory(geom, ba, dm, {ng_eb,ng_eb,ng_eb}, EBSupport::full);
+
+    const int ncomp = 5;
+    const int ng = 5;
+    MultiFab U_in(ba, dm, ncomp, ng, MFInfo(), *factory);
+    MultiFab dUdt_in(ba, dm, ncomp, ng, MFInfo(), *factory);
+    amrex::InitRandom(1234 + ParallelDescriptor::MyProc());
+    for (MFIter mfi(U_in); mfi.isValid(); ++mfi)
+    {
+        auto const& u = U_in.array(mfi);
+        auto const& dudt = dUdt_in.array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), ncomp, [&] (int i, int j, int k, int n)
+        {
+            u(i,j,k,n) = 1.0_rt + amrex::Random();
+            dudt(i,j,k,n) = amrex::Random() - 0.5_rt;
+        });
+    }
+    U_in.FillBoundary(geom.periodicity());
+    dUdt_in.FillBoundary(geom.periodicity());
+
+    Vector<BCRec> bcrec(ncomp);
+    for (auto& bc : bcrec) {
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            bc.setLo(idim, BCType::foextrap);
+            bc.setHi(idim, BCType::foextrap);
+        }
+    }
+
+    const Real dt = 0.1_rt;
+    const Real target_volfrac = 0.5_rt;
+    const StateRedistPlan plan(*factory, geom, target_volfrac);
+    AMREX_ALWAYS_ASSERT(plan.isValidFor(ba, dm));
+
+    auto const& flags = factory->getMultiEBCellFlagFab();
+    auto const& vfrac = factory->getVolFrac();
+    auto const& ccent = factory->getCentroid();
+    auto const& area = factory->getAreaFrac();
+    auto const& fcent = factory->getFaceCent();
+
+    MultiFab out_ref(ba, dm, ncomp, 0);
+    MultiFab out_plan(ba, dm, ncomp, 0);
+    out_ref.setVal(0.0);
+    out_plan.setVal(0.0);
+
+    Long nboxes_without_plan = 0;
+    for (MFIter mfi(U_in); mfi.isValid(); ++mfi)
+    {
+        Box const& bx = mfi.validbox();
+        const FabType type = flags[mfi].getType();
+        if (type == FabType::covered) {
+            out_ref[mfi].copy<RunOn::Host>(dUdt_in[mfi], bx);
+            out_plan[mfi].copy<RunOn::Host>(dUdt_in[mfi], bx);
+            continue;
+        }
+        if (type == FabType::regular) {
+            AMREX_ALWAYS_ASSERT(plan.const_arrays(mfi).box.isEmpty());
+            ++nboxes_without_plan;
+        }
+
+        // Both calls may change dUdt_in and scratch
+        FArrayBox dudt_ref(dUdt_in[mfi].box(), ncomp);
+        FArrayBox dudt_plan(dUdt_in[mfi].box(), ncomp);
+        dudt_ref.copy<RunOn::Host>(dUdt_in[mfi]);
+        dudt_plan.copy<RunOn::Host>(dUdt_in[mfi]);
+        FArrayBox scratch(U_in[mfi].box(), ncomp);
+
+        // Without the plan, regular boxes are copied as applications do
+        if (type == FabType::regular) {
+            out_ref[mfi].copy<RunOn::Host>(dudt_ref, bx);
+        } else {
+            ApplyRedistribution(bx, ncomp, out_ref.array(mfi), dudt_ref.array(),
+                                U_in.const_array(mfi), scratch.array(),
+                                flags.const_array(mfi),
+                                AMREX_D_DECL(area[0]->const_array(mfi),
+                                             area[1]->const_array(mfi),
+                                             area[2]->const_array(mfi)),
+                                vfrac.const_array(mfi),
+                                AMREX_D_DECL(fcent[0]->const_array(mfi),
+                                             fcent[1]->const_array(mfi),
+                                             fcent[2]->const_array(mfi)),
+                                ccent.const_array(mfi), bcrec.data(), geom, dt,
+                                "StateRedist", false, 2, target_volfrac);
+        }
+
+        ApplyRedistribution(bx, ncomp, out_plan.array(mfi), dudt_plan.array(),
+                            U_in.const_array(mfi), scratch.array(),
+                            flags.const_array(mfi), vfrac.const_array(mfi),
+                            AMREX_D_DECL(fcent[0]->const_array(mfi),
+                                         fcent[1]->const_array(mfi),
+                                         fcent[2]->const_array(mfi)),
+                            ccent.const_array(mfi), bcrec.data(), geom, dt,
+                            plan.const_arrays(mfi));
+    }
+    ParallelDescriptor::ReduceLongSum(nboxes_without_plan);
+
+    // The redistribution must have changed the update
+    MultiFab::Subtract(out_ref, dUdt_in, 0, 0, ncomp, 0);
+    MultiFab::Subtract(out_plan, dUdt_in, 0, 0, ncomp, 0);
+    const Real change = out_ref.norminf(0, ncomp, IntVect(0));
+
+    MultiFab::Subtract(out_plan, out_ref, 0, 0, ncomp, 0);
+    const Real diff = out_plan.norminf(0, ncomp, IntVect(0));
+
+    amrex::Print() << nboxes_without_plan << " boxes without plan, max change "
+                   << change << ", max difference " << diff << "\n";
+    AMREX_ALWAYS_ASSERT(nboxes_without_plan > 0 && change > 0.0_rt && diff == 0.0_rt);
+
+    amrex::Print() << "pass\n";
+}
@@ -82,6 +82,8 @@ int main (int argc, char* argv[])
         if (amr.stepOfLastPlotFile() < amr.levelSteps(0)) {
             amr.writePlotFile();
         }
+
+        amr.finalize();
     }
 
     timer_tot = amrex::second() - timer_tot;
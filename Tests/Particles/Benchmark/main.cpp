@@ -0,0 +1,287 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_FileSystem.H>
+#include <AMReX_Particles.H>
+#include <AMReX_NeighborParticles.H>
+#include <AMReX_ParticleMesh.H>
+#include <AMReX_ParticleInterpolators.H>
+
+#include <iomanip>
+#include <string>
+#include <utility>
+
+using namespace amrex;
+
+//
+// Throughput of the main steps of a particle-in-cell pipeline. For each number
+// of particles per cell, every kernel is run nsteps times after one untimed
+// warm-up. The particle moves before each Redistribute are not timed. The
+// slowest rank's time is reported as seconds per step and as particles per
+// second per core (MPI ranks times OpenMP threads). The inputs
+// are fixed and the particles are placed with a fixed seed, so runs with the
+// same inputs and number of ranks can be compared to catch regressions.
+//
+
+struct TestParams
+{
+    IntVect size;
+    int max_grid_size;
+    Vector<int> nppc;
+    int nsteps;
+    int neighbor_cells;
+    int do_io;
+    std::string io_dir;
+};
+
+static constexpr int NR = 1 + AMREX_SPACEDIM; // mass and velocity
+using PC = NeighborParticleContainer<NR, 0>;
+using PType = PC::ParticleType;
+
+struct CheckPair
+{
+    Real cutoff_sq;
+
+    template <class P1, class P2>
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    bool operator() (const P1& p1, const P2& p2) const
+    {
+        AMREX_D_TERM(Real d0 = (p1.pos(0) - p2.pos(0));,
+                     Real d1 = (p1.pos(1) - p2.pos(1));,
+                     Real d2 = (p1.pos(2) - p2.pos(2));)
+        return AMREX_D_TERM(d0*d0, + d1*d1, + d2*d2) <= cutoff_sq;
+    }
+};
+
+void get_test_params (TestParams& params, const std::string& prefix)
+{
+    ParmParse pp(prefix);
+    pp.get("size", params.size);
+    pp.get("max_grid_size", params.max_grid_size);
+    pp.getarr("nppc", params.nppc);
+    params.nsteps = 5;
+    pp.query("nsteps", params.nsteps);
+    params.neighbor_cells = 4;
+    pp.query("neighbor_cells", params.neighbor_cells);
+    params.do_io = 1;
+    pp.query("do_io", params.do_io);
+    params.io_dir = "bench_particles";
+    pp.query("io_dir", params.io_dir);
+}
+
+//! Displace every particle by up to max_cells cells in each direction,
+//! or anywhere in the domain if max_cells is negative.
+void moveParticles (PC& pc, Real max_cells)
+{
+    const auto& geom = pc.Geom(0);
+    const auto dx = geom.CellSizeArray();
+    const auto plo = geom.ProbLoArray();
+    const auto phi = geom.ProbHiArray();
+    for (PC::ParIterType pti(pc, 0); pti.isValid(); ++pti)
+    {
+        auto* pstruct = pti.GetArrayOfStructs()().dataPtr();
+        amrex::ParallelForRNG(pti.numParticles(),
+        [=] AMREX_GPU_DEVICE (int i, RandomEngine const& engine) noexcept
+        {
+            auto& p = pstruct[i];
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                if (max_cells < 0) {
+                    p.pos(idim) = static_cast<ParticleReal>(plo[idim] + Random(engine)*(phi[idim]-plo[idim]));
+                } else {
+                    p.pos(idim) += static_cast<ParticleReal>((2*Random(engine)-1)*max_cells*dx[idim]);
+                }
+            }
+        });
+    }
+    Gpu::streamSynchronize();
+}
+
+template <class Interp>
+void depositMass (PC& pc, MultiFab& rho)
+{
+    const auto plo = pc.Geom(0).ProbLoArray();
+    const auto dxi = pc.Geom(0).InvCellSizeArray();
+    rho.setVal(0.0);
+    amrex::ParticleToMesh(pc, rho, 0,
+        [=] AMREX_GPU_DEVICE (const PType& p, Array4<Real> const& arr)
+        {
+            Interp interp(p, plo, dxi);
+            interp.ParticleToMesh(p, arr, 0, 0, 1,
+                [=] AMREX_GPU_DEVICE (const PType& part, int comp)
+                {
+                    return part.rdata(comp);
+                });
+        });
+}
+
+template <class Interp>
+void gatherField (PC& pc, const MultiFab& field)
+{
+    const auto plo = pc.Geom(0).ProbLoArray();
+    const auto dxi = pc.Geom(0).InvCellSizeArray();
+    amrex::MeshToParticle(pc, field, 0,
+        [=] AMREX_GPU_DEVICE (PType& p, Array4<const Real> const& arr)
+        {
+            Interp interp(p, plo, dxi);
+            interp.MeshToParticle(p, arr, 0, 1, AMREX_SPACEDIM,
+                [=] AMREX_GPU_DEVICE (Array4<const Real> const& a, int i, int j, int k, int comp)
+                {
+                    return a(i, j, k, comp);
+                },
+                [=] AMREX_GPU_DEVICE (PType& part, int comp, Real val)
+                {
+                    part.rdata(comp) += static_cast<ParticleReal>(val);
+                });
+        });
+}
+
+//! Run setup and f once untimed, then nsteps times, and print the throughput
+//! of f. Only f is timed.
+template <class S, class F>
+void timeKernel (const std::string& name, int nppc, Long np, int nsteps, S&& setup, F&& f)
+{
+    setup();
+    f();
+
+    Real t = 0.0;
+    for (int step = 0; step < nsteps; ++step) {
+        setup();
+        Gpu::streamSynchronize();
+        ParallelDescriptor::Barrier();
+        const Real t0 = amrex::second();
+        f();
+        Gpu::streamSynchronize();
+        t += amrex::second() - t0;
+    }
+    t /= nsteps;
+    ParallelDescriptor::ReduceRealMax(t);
+
+    const int ncores = ParallelDescriptor::NProcs() * OpenMP::get_max_threads();
+    amrex::Print() << std::left << std::setw(24) << name << std::right
+                   << std::setw(6) << nppc
+                   << std::setw(14) << np
+                   << std::setw(14) << std::setprecision(4) << std::scientific << t
+                   << std::setw(18) << static_cast<Real>(np) / (t * ncores)
+                   << std::defaultfloat << "\n";
+}
+
+template <class F>
+void timeKernel (const std::string& name, int nppc, Long np, int nsteps, F&& f)
+{
+    timeKernel(name, nppc, np, nsteps, [] () {}, std::forward<F>(f));
+}
+
+void benchmark (const TestParams& params, const Geometry& geom, const BoxArray& ba,
+                const DistributionMapping& dm, int nppc)
+{
+    PC pc(geom, dm, ba, 1);
+
+    amrex::ResetRandomSeed(42 + ParallelDescriptor::MyProc(), 42 + ParallelDescriptor::MyProc());
+    PC::ParticleInitData pdata = {{1.0, AMREX_D_DECL(0.0, 0.0, 0.0)}, {}, {}, {}};
+    pc.InitNRandomPerCell(nppc, pdata);
+    const Long np = pc.TotalNumberOfParticles();
+    const int nsteps = params.nsteps;
+
+    timeKernel("RedistributeLocal", nppc, np, nsteps,
+               [&] () { moveParticles(pc, 0.25); },
+               [&] () { pc.RedistributeLocal(); });
+
+    timeKernel("RedistributeNeighbor", nppc, np, nsteps,
+               [&] () { moveParticles(pc, params.neighbor_cells); },
+               [&] () { pc.Redistribute(0, -1, 0, params.neighbor_cells); });
+
+    timeKernel("RedistributeGlobal", nppc, np, nsteps,
+               [&] () { moveParticles(pc, -1); },
+               [&] () { pc.Redistribute(); });
+
+    timeKernel("SortParticlesByBin", nppc, np, nsteps, [&] () {
+        pc.SortParticlesByBin(IntVect(1));
+    });
+
+    MultiFab rho(ba, dm, 1, 2);
+    MultiFab field(ba, dm, AMREX_SPACEDIM, 2);
+    field.setVal(1.0);
+
+    timeKernel("ParticleToMesh NGP", nppc, np, nsteps,
+               [&] () { depositMass<ParticleInterpolator::Nearest>(pc, rho); });
+    timeKernel("ParticleToMesh CIC", nppc, np, nsteps,
+               [&] () { depositMass<ParticleInterpolator::Linear>(pc, rho); });
+    timeKernel("ParticleToMesh TSC", nppc, np, nsteps,
+               [&] () { depositMass<ParticleInterpolator::Quadratic>(pc, rho); });
+    AMREX_ALWAYS_ASSERT(std::abs(rho.sum(0) - static_cast<Real>(np)) <= 1.e-8*static_cast<Real>(np));
+
+    timeKernel("MeshToParticle NGP", nppc, np, nsteps,
+               [&] () { gatherField<ParticleInterpolator::Nearest>(pc, field); });
+    timeKernel("MeshToParticle CIC", nppc, np, nsteps,
+               [&] () { gatherField<ParticleInterpolator::Linear>(pc, field); });
+    timeKernel("MeshToParticle TSC", nppc, np, nsteps,
+               [&] () { gatherField<ParticleInterpolator::Quadratic>(pc, field); });
+
+    const Real cutoff = geom.CellSize(0);
+    timeKernel("NeighborList", nppc, np, nsteps, [&] () {
+        pc.clearNeighbors();
+        pc.fillNeighbors();
+        pc.buildNeighborList(CheckPair{cutoff*cutoff});
+    });
+    pc.clearNeighbors();
+
+    if (params.do_io) {
+        const std::string dir = params.io_dir + "_" + std::to_string(nppc);
+        timeKernel("Checkpoint", nppc, np, nsteps, [&] () {
+            pc.Checkpoint(dir, "particles");
+        });
+        // Restart adds to the particles already in a container
+        timeKernel("Restart", nppc, np, nsteps, [&] () {
+            PC pc_restart(geom, dm, ba, 1);
+            pc_restart.Restart(dir, "particles");
+            AMREX_ALWAYS_ASSERT(pc_restart.TotalNumberOfParticles() == np);
+        });
+        if (ParallelDescriptor::IOProcessor()) { FileSystem::RemoveAll(dir); }
+    }
+
+    AMREX_ALWAYS_ASSERT(pc.TotalNumberOfParticles() == np);
+}
+
+void runBenchmarks ()
+{
+    TestParams params;
+    get_test_params(params, "bench");
+
+    RealBox real_box;
+    for (int n = 0; n < AMREX_SPACEDIM; n++) {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, params.size[n]);
+    }
+    const Box domain(IntVect(AMREX_D_DECL(0, 0, 0)), params.size - 1);
+    Array<int,AMREX_SPACEDIM> is_per{AMREX_D_DECL(1, 1, 1)};
+    Geometry geom(domain, real_box, CoordSys::cartesian, is_per);
+
+    BoxArray ba(domain);
+    ba.maxSize(params.max_grid_size);
+    DistributionMapping dm(ba);
+
+    amrex::Print() << "Particle benchmarks: domain " << domain.size()
+                   << ", max_grid_size " << params.max_grid_size
+                   << ", " << ba.size() << " boxes, "
+                   << ParallelDescriptor::NProcs() << " MPI ranks x "
+                   << OpenMP::get_max_threads() << " threads, "
+                   << params.nsteps << " steps\n";
+    amrex::Print() << std::left << std::setw(24) << "kernel" << std::right
+                   << std::setw(6) << "nppc"
+                   << std::setw(14) << "particles"
+                   << std::setw(14) << "s/step"
+                   << std::setw(18) << "particles/s/core" << "\n";
+
+    for (int nppc : params.nppc) {
+        benchmark(params, geom, ba, dm, nppc);
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    runBenchmarks();
+
+    amrex::Finalize();
+}
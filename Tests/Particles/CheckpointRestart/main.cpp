@@ -23,7 +23,7 @@ void test ()
 {
     const int nghost = 0;
     int ncells, max_grid_size, ncomp, nlevs, nppc;
-    int restart_check = 0, nplotfile = 1, nparticlefile = 1;
+    int restart_check = 0, columnar_check = 0, nplotfile = 1, nparticlefile = 1;
     std::string directory;
 
     ParmParse pp;
@@ -35,6 +35,7 @@ void test ()
     pp.query("nplotfile", nplotfile);
     pp.query("nparticlefile", nparticlefile);
     pp.query("restart_check", restart_check);
+    pp.query("columnar_check", columnar_check);
     pp.query("directory", directory);
 
     if (!directory.empty() && directory.back() != '/') {
@@ -138,6 +139,14 @@ void test ()
 
             myPC.Checkpoint(fname, "particle0", false, particle_realnames, particle_intnames);
 
+            if (columnar_check) {
+                Vector<int> write_real_comp(particle_realnames.size(), 1);
+                Vector<int> write_int_comp(particle_intnames.size(), 1);
+                myPC.WriteColumnarPlotFile(fname, "particle_columnar",
+                                           write_real_comp, write_int_comp,
+                                           particle_realnames, particle_intnames);
+            }
+
             amrex::Print() << " done \n";
         }
     }
@@ -173,6 +182,77 @@ void test ()
             AMREX_ALWAYS_ASSERT(sm_old == sm_new);
         }
     }
+
+    if (columnar_check && nparticlefile > 0)
+    {
+        std::snprintf(directory_path, sizeof directory_path, "%s%s", directory.c_str(),
+                      "plt00000/particle_columnar");
+        ColumnarParticleReader reader(directory_path);
+        AMREX_ALWAYS_ASSERT(reader.numParticles() == myPC.TotalNumberOfParticles());
+
+        // Read one real and one int component, and the positions of the
+        // grids that may hold particles in the lower corner of the domain.
+        const int rcomp = reader.realComp("particle_real_component_1");
+        const int icomp = reader.intComp("particle_int_component_0");
+        AMREX_ALWAYS_ASSERT(rcomp == AMREX_SPACEDIM+1 && icomp == 0);
+
+        const RealBox corner(AMREX_D_DECL(0.0,0.0,0.0), AMREX_D_DECL(0.3,0.3,0.3));
+
+        const int rank = ParallelDescriptor::MyProc();
+        const int nprocs = ParallelDescriptor::NProcs();
+        Real rsum = 0.0;
+        Long isum = 0;
+        Long ncorner = 0;
+        Vector<ParticleReal> rdata;
+        Vector<int> idata;
+        for (int lev = 0; lev <= reader.finestLevel(); ++lev) {
+            for (int grid = rank; grid < reader.numGrids(lev); grid += nprocs) {
+                reader.readReal(lev, grid, rcomp, rdata);
+                reader.readInt(lev, grid, icomp, idata);
+                for (auto x : rdata) { rsum += x; }
+                for (auto x : idata) { isum += x; }
+            }
+            for (int grid : reader.gridsIntersecting(lev, corner)) {
+                if (grid % nprocs != rank) { continue; }
+                Vector<Vector<ParticleReal> > pos(AMREX_SPACEDIM);
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    reader.readReal(lev, grid, idim, pos[idim]);
+                }
+                for (Long i = 0; i < reader.numParticles(lev, grid); ++i) {
+                    bool inside = true;
+                    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                        inside = inside && (pos[idim][i] >= corner.lo(idim) && pos[idim][i] <= corner.hi(idim));
+                    }
+                    if (inside) { ++ncorner; }
+                }
+            }
+        }
+        ParallelDescriptor::ReduceRealSum(rsum);
+        ParallelDescriptor::ReduceLongSum(isum);
+        ParallelDescriptor::ReduceLongSum(ncorner);
+
+        using PType = typename MyPC::SuperParticleType;
+        amrex::ReduceOps<ReduceOpSum, ReduceOpSum, ReduceOpSum> reduce_ops;
+        auto r = amrex::ParticleReduce<ReduceData<Real,Long,Long>>(myPC,
+            [=] AMREX_GPU_DEVICE (const PType& p) -> GpuTuple<Real,Long,Long>
+            {
+                bool inside = true;
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    inside = inside && (p.pos(idim) >= corner.lo(idim) && p.pos(idim) <= corner.hi(idim));
+                }
+                return {p.rdata(1), p.idata(0), inside ? 1 : 0};
+            }, reduce_ops);
+        Real rsum_old = amrex::get<0>(r);
+        Long isum_old = amrex::get<1>(r);
+        Long ncorner_old = amrex::get<2>(r);
+        ParallelDescriptor::ReduceRealSum(rsum_old);
+        ParallelDescriptor::ReduceLongSum(isum_old);
+        ParallelDescriptor::ReduceLongSum(ncorner_old);
+
+        AMREX_ALWAYS_ASSERT(amrex::almostEqual(rsum, rsum_old, 100));
+        AMREX_ALWAYS_ASSERT(isum == isum_old);
+        AMREX_ALWAYS_ASSERT(ncorner == ncorner_old && ncorner > 0);
+    }
 }
 
 void set_grids_nested (Vector<Box>& domains,
@@ -0,0 +1,182 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Particles.H>
+
+#include <algorithm>
+#include <fstream>
+
+using namespace amrex;
+
+// the file has one more real than is read
+static constexpr int NX = 3;
+static constexpr int NEXTRA = 2;
+using PC = ParticleContainer<NX, 0>;
+
+struct TestParams
+{
+    IntVect size;
+    int max_grid_size;
+    Long num_particles;
+};
+
+template <class T>
+void writeBinaryFile (const std::string& file, Long np);
+
+void testInitFromBinaryFile (const std::string& file, const TestParams& params);
+
+//
+// Write the same particles to binary files with floats and with doubles, and
+// check that InitFromBinaryFileCollective reads the same particles from them
+// as InitFromBinaryFile.  The number of particles is odd, so that it is not
+// divided evenly among the processes of the test.
+//
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    TestParams params;
+    {
+        ParmParse pp("binary");
+        pp.get("size", params.size);
+        pp.get("max_grid_size", params.max_grid_size);
+        pp.get("num_particles", params.num_particles);
+    }
+
+    writeBinaryFile<float>("particles_float.bin", params.num_particles);
+    testInitFromBinaryFile("particles_float.bin", params);
+
+    writeBinaryFile<double>("particles_double.bin", params.num_particles);
+    testInitFromBinaryFile("particles_double.bin", params);
+
+    amrex::Print() << "pass \n";
+
+    amrex::Finalize();
+}
+
+//! Particle i is at a position that depends on i, with extradata i and -i/2
+template <class T>
+void writeBinaryFile (const std::string& file, Long np)
+{
+    if (ParallelDescriptor::IOProcessor())
+    {
+        std::ofstream ofs(file, std::ios::out|std::ios::binary|std::ios::trunc);
+        const int dm = AMREX_SPACEDIM;
+        const int nx = NX;
+        ofs.write((const char*)&np, sizeof(np));
+        ofs.write((const char*)&dm, sizeof(dm));
+        ofs.write((const char*)&nx, sizeof(nx));
+        for (Long i = 0; i < np; ++i)
+        {
+            T rec[AMREX_SPACEDIM+NX] = {AMREX_D_DECL(T((i*37 % 101) + 0.5) / T(101.),
+                                                     T((i*53 % 97) + 0.5) / T(97.),
+                                                     T((i*71 % 89) + 0.5) / T(89.)),
+                                        T(i), T(-0.5)*T(i), T(-1.)};
+            ofs.write((const char*)rec, sizeof(rec));
+        }
+        if (!ofs.good()) { amrex::FileOpenFailed(file); }
+    }
+    ParallelDescriptor::Barrier();
+}
+
+//! For each particle of the file, its position, extradata, id and cpu
+struct FileParticles
+{
+    Vector<ParticleReal> pos;
+    Vector<ParticleReal> extra;
+    Vector<Long> idcpu;
+    Vector<int> count;
+};
+
+FileParticles gatherParticles (PC& pc, Long np)
+{
+    FileParticles fp;
+    fp.pos.resize(np*AMREX_SPACEDIM, 0.);
+    fp.extra.resize(np, 0.);
+    fp.idcpu.resize(2*np, 0);
+    fp.count.resize(np, 0);
+
+    for (int lev = 0; lev <= pc.finestLevel(); ++lev)
+    {
+        for (auto& kv : pc.GetParticles(lev))
+        {
+            const auto& aos = kv.second.GetArrayOfStructs();
+            Gpu::HostVector<PC::ParticleType> h_aos(aos.size());
+            Gpu::copy(Gpu::deviceToHost, aos.begin(), aos.end(), h_aos.begin());
+            for (auto const& p : h_aos)
+            {
+                const auto i = static_cast<Long>(p.rdata(0));
+                AMREX_ALWAYS_ASSERT(i >= 0 && i < np);
+                for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                    fp.pos[i*AMREX_SPACEDIM+d] = p.pos(d);
+                }
+                fp.extra[i] = p.rdata(1);
+                fp.idcpu[2*i] = p.id();
+                fp.idcpu[2*i+1] = p.cpu();
+                ++fp.count[i];
+            }
+        }
+    }
+
+    ParallelDescriptor::ReduceRealSum(fp.pos.data(), int(fp.pos.size()));
+    ParallelDescriptor::ReduceRealSum(fp.extra.data(), int(fp.extra.size()));
+    ParallelDescriptor::ReduceLongSum(fp.idcpu.data(), int(fp.idcpu.size()));
+    ParallelDescriptor::ReduceIntSum(fp.count.data(), int(fp.count.size()));
+    return fp;
+}
+
+void checkIdsAreUnique (const FileParticles& fp)
+{
+    const auto np = static_cast<Long>(fp.count.size());
+    Vector<std::pair<Long,Long> > idcpu(np);
+    for (Long i = 0; i < np; ++i) {
+        idcpu[i] = std::make_pair(fp.idcpu[2*i], fp.idcpu[2*i+1]);
+    }
+    std::sort(idcpu.begin(), idcpu.end());
+    AMREX_ALWAYS_ASSERT(std::adjacent_find(idcpu.begin(), idcpu.end()) == idcpu.end());
+}
+
+void testInitFromBinaryFile (const std::string& file, const TestParams& params)
+{
+    RealBox real_box;
+    for (int n = 0; n < AMREX_SPACEDIM; n++) {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, 1.0);
+    }
+
+    const Box domain(IntVect(0), params.size - 1);
+    Array<int,AMREX_SPACEDIM> is_per{AMREX_D_DECL(1,1,1)};
+    const Geometry geom(domain, real_box, CoordSys::cartesian, is_per);
+
+    BoxArray ba(domain);
+    ba.maxSize(params.max_grid_size);
+    DistributionMapping dm(ba);
+
+    const Long np = params.num_particles;
+
+    PC pc_serial(geom, dm, ba);
+    pc_serial.InitFromBinaryFile(file, NEXTRA);
+
+    PC pc_collective(geom, dm, ba);
+    pc_collective.InitFromBinaryFileCollective(file, NEXTRA);
+
+    AMREX_ALWAYS_ASSERT(pc_serial.TotalNumberOfParticles() == np);
+    AMREX_ALWAYS_ASSERT(pc_collective.TotalNumberOfParticles() == np);
+    AMREX_ALWAYS_ASSERT(pc_collective.OK());
+
+    const auto serial = gatherParticles(pc_serial, np);
+    const auto collective = gatherParticles(pc_collective, np);
+
+    // every particle of the file is read exactly once
+    for (Long i = 0; i < np; ++i) {
+        AMREX_ALWAYS_ASSERT(serial.count[i] == 1 && collective.count[i] == 1);
+        AMREX_ALWAYS_ASSERT(collective.extra[i] == ParticleReal(-0.5)*ParticleReal(i));
+    }
+    AMREX_ALWAYS_ASSERT(serial.pos == collective.pos);
+    AMREX_ALWAYS_ASSERT(serial.extra == collective.extra);
+
+    checkIdsAreUnique(serial);
+    checkIdsAreUnique(collective);
+
+    amrex::Print() << file << ": the " << np << " particles match\n";
+}
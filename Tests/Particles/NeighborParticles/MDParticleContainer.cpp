@@ -229,6 +229,34 @@ void MDParticleContainer::moveParticles(amrex::ParticleReal dx)
     }
 }
 
+void MDParticleContainer::jiggleParticles(amrex::ParticleReal dx)
+{
+    BL_PROFILE("MDParticleContainer::jiggleParticles");
+
+    const int lev = 0;
+    auto& plev  = GetParticles(lev);
+
+    for(MFIter mfi = MakeMFIter(lev); mfi.isValid(); ++mfi)
+    {
+        int gid = mfi.index();
+        int tid = mfi.LocalTileIndex();
+
+        auto& ptile = plev[std::make_pair(gid, tid)];
+        auto& aos   = ptile.GetArrayOfStructs();
+        ParticleType* pstruct = aos.data();
+
+        const size_t np = aos.numParticles();
+
+        // move particles with even and odd ids in opposite directions,
+        // so that the pair distances change
+        AMREX_FOR_1D ( np, i,
+        {
+            ParticleType& p = pstruct[i];
+            p.pos(0) += (p.id() % 2 == 0) ? dx : -dx;
+        });
+    }
+}
+
 void MDParticleContainer::writeParticles(int n)
 {
     BL_PROFILE("MDParticleContainer::writeParticles");
@@ -371,6 +399,271 @@ void MDParticleContainer::checkNeighborList()
     amrex::PrintToFile("neighbor_test") << "All the neighbor list particles match!" << '\n';
 }
 
+void MDParticleContainer::checkVerletNeighborList()
+{
+    BL_PROFILE("MDParticleContainer::checkVerletNeighborList");
+
+    const int lev = 0;
+    auto& plev  = GetParticles(lev);
+
+    for (MFIter mfi = MakeMFIter(lev); mfi.isValid(); ++mfi)
+    {
+        int gid = mfi.index();
+
+        int tid = mfi.LocalTileIndex();
+        auto index = std::make_pair(gid, tid);
+
+        auto& ptile = plev[index];
+        auto& aos   = ptile.GetArrayOfStructs();
+
+        const int np       = aos.numParticles();
+        const int np_total = aos.numTotalParticles();
+
+        amrex::Gpu::HostVector<ParticleType> h_pstruct(np_total);
+        Gpu::copy(Gpu::deviceToHost, aos().dataPtr(), aos().dataPtr() + np_total, h_pstruct.begin());
+
+        auto& d_counts = m_neighbor_list[lev][index].GetCounts();
+        Gpu::HostVector<unsigned int> h_counts(d_counts.size());
+        Gpu::copy(Gpu::deviceToHost, d_counts.begin(), d_counts.end(), h_counts.begin());
+
+        auto& d_list = m_neighbor_list[lev][index].GetList();
+        Gpu::HostVector<unsigned int> h_list(d_list.size());
+        Gpu::copy(Gpu::deviceToHost, d_list.begin(), d_list.end(), h_list.begin());
+
+        // the list was built with the skin, so it may hold extra pairs, but
+        // every pair within the cutoff at the current positions must be in it
+        unsigned start = 0;
+        for (int i = 0; i < np; i++)
+        {
+            ParticleType& p1 = h_pstruct[i];
+            const unsigned int* nbors = h_list.data() + start;
+            for (int j = 0; j < np_total; j++)
+            {
+                if ( i == j ) { continue; }
+
+                ParticleType& p2 = h_pstruct[j];
+                AMREX_D_TERM(Real dx = p1.pos(0) - p2.pos(0);,
+                             Real dy = p1.pos(1) - p2.pos(1);,
+                             Real dz = p1.pos(2) - p2.pos(2);)
+
+                Real r2 = AMREX_D_TERM(dx*dx, + dy*dy, + dz*dz);
+
+                Real cutoff_sq = 25.0*Params::cutoff*Params::cutoff;
+
+                if (r2 <= cutoff_sq)
+                {
+                    AMREX_ALWAYS_ASSERT(std::find(nbors, nbors + h_counts[i], j) != nbors + h_counts[i]);
+                }
+            }
+            start += h_counts[i];
+        }
+    }
+
+    amrex::PrintToFile("neighbor_test") << "All the Verlet neighbor list pairs are present!" << '\n';
+}
+
+void MDParticleContainer::countNeighborsWithHalfList()
+{
+    BL_PROFILE("MDParticleContainer::countNeighborsWithHalfList");
+
+    const int lev = 0;
+    auto& plev  = GetParticles(lev);
+
+    for (MFIter mfi = MakeMFIter(lev); mfi.isValid(); ++mfi)
+    {
+        int gid = mfi.index();
+        int tid = mfi.LocalTileIndex();
+        auto index = std::make_pair(gid, tid);
+
+        auto& ptile = plev[index];
+        auto& aos   = ptile.GetArrayOfStructs();
+        const size_t np       = aos.numParticles();
+        const size_t np_total = aos.numTotalParticles();
+
+        auto nbor_data = m_neighbor_list[lev][index].data();
+        ParticleType* pstruct = aos().dataPtr();
+
+        AMREX_FOR_1D ( np_total, i,
+        {
+            pstruct[i].rdata(PIdx::ax) = 0.0;
+        });
+
+        // each pair is only stored once, so count it for both particles
+        AMREX_FOR_1D ( np, i,
+        {
+            for (auto& p2 : nbor_data.getNeighbors(i))
+            {
+                Gpu::Atomic::AddNoRet(&(pstruct[i].rdata(PIdx::ax)), ParticleReal(1.0));
+                Gpu::Atomic::AddNoRet(&(p2.rdata(PIdx::ax)), ParticleReal(1.0));
+            }
+        });
+    }
+}
+
+void MDParticleContainer::countNeighborsWithHalfCellList()
+{
+    BL_PROFILE("MDParticleContainer::countNeighborsWithHalfCellList");
+
+    const int lev = 0;
+    const Geometry& geom = Geom(lev);
+    auto& plev  = GetParticles(lev);
+
+    for (MFIter mfi = MakeMFIter(lev); mfi.isValid(); ++mfi)
+    {
+        int gid = mfi.index();
+        int tid = mfi.LocalTileIndex();
+        auto index = std::make_pair(gid, tid);
+
+        auto& ptile = plev[index];
+        auto& aos   = ptile.GetArrayOfStructs();
+        const size_t np_total = aos.numTotalParticles();
+        ParticleType* pstruct = aos().dataPtr();
+
+        AMREX_FOR_1D ( np_total, i,
+        {
+            pstruct[i].rdata(PIdx::ax) = 0.0;
+        });
+
+        amrex::NeighborCellList cell_list;
+        cell_list.build(ptile, amrex::grow(mfi.tilebox(), m_num_neighbor_cells), geom);
+
+        // each pair is only visited once, so count it for both particles
+        const auto cutoff = static_cast<ParticleReal>(5.0*Params::cutoff);
+        cell_list.forEachPair(cutoff, [=] AMREX_GPU_DEVICE (int i, int j, ParticleReal /*r2*/)
+        {
+            Gpu::Atomic::AddNoRet(&(pstruct[i].rdata(PIdx::ax)), ParticleReal(1.0));
+            Gpu::Atomic::AddNoRet(&(pstruct[j].rdata(PIdx::ax)), ParticleReal(1.0));
+        }, true);
+    }
+}
+
+void MDParticleContainer::checkHalfNeighborList()
+{
+    BL_PROFILE("MDParticleContainer::checkHalfNeighborList");
+
+    const int lev = 0;
+    auto& plev  = GetParticles(lev);
+
+    for (MFIter mfi = MakeMFIter(lev); mfi.isValid(); ++mfi)
+    {
+        int gid = mfi.index();
+        int tid = mfi.LocalTileIndex();
+        auto index = std::make_pair(gid, tid);
+
+        auto& ptile = plev[index];
+        auto& aos   = ptile.GetArrayOfStructs();
+
+        const int np       = aos.numParticles();
+        const int np_total = aos.numTotalParticles();
+
+        amrex::Gpu::HostVector<ParticleType> h_pstruct(np_total);
+        Gpu::copy(Gpu::deviceToHost, aos().dataPtr(), aos().dataPtr() + np_total, h_pstruct.begin());
+
+        // after summing the ghost contributions back, every particle must
+        // have counted all of its neighbors
+        for (int i = 0; i < np; i++)
+        {
+            ParticleType& p1 = h_pstruct[i];
+            int count = 0;
+            for (int j = 0; j < np_total; j++)
+            {
+                if ( i == j ) { continue; }
+
+                ParticleType& p2 = h_pstruct[j];
+                AMREX_D_TERM(Real dx = p1.pos(0) - p2.pos(0);,
+                             Real dy = p1.pos(1) - p2.pos(1);,
+                             Real dz = p1.pos(2) - p2.pos(2);)
+
+                Real r2 = AMREX_D_TERM(dx*dx, + dy*dy, + dz*dz);
+
+                Real cutoff_sq = 25.0*Params::cutoff*Params::cutoff;
+
+                if (r2 <= cutoff_sq) { ++count; }
+            }
+            AMREX_ALWAYS_ASSERT(int(p1.rdata(PIdx::ax)) == count);
+        }
+    }
+
+    amrex::PrintToFile("neighbor_test") << "All the half neighbor list counts match!" << '\n';
+}
+
+void MDParticleContainer::checkNeighborCellList()
+{
+    BL_PROFILE("MDParticleContainer::checkNeighborCellList");
+
+    const int lev = 0;
+    const Geometry& geom = Geom(lev);
+    auto& plev  = GetParticles(lev);
+
+    for (MFIter mfi = MakeMFIter(lev); mfi.isValid(); ++mfi)
+    {
+        int gid = mfi.index();
+        int tid = mfi.LocalTileIndex();
+        auto index = std::make_pair(gid, tid);
+
+        auto& ptile = plev[index];
+        auto& aos   = ptile.GetArrayOfStructs();
+
+        const int np       = aos.numParticles();
+        const int np_total = aos.numTotalParticles();
+
+        amrex::NeighborCellList cell_list;
+        cell_list.build(ptile, amrex::grow(mfi.tilebox(), m_num_neighbor_cells), geom);
+
+        const auto cutoff = static_cast<ParticleReal>(5.0*Params::cutoff);
+
+        // count the pairs of each particle with full and half traversals; the
+        // half traversal only visits a pair from the particle with the smaller id/cpu
+        amrex::Gpu::DeviceVector<int> full_count(np, 0);
+        amrex::Gpu::DeviceVector<int> half_count(np, 0);
+        int* pfull = full_count.dataPtr();
+        int* phalf = half_count.dataPtr();
+        cell_list.forEachPair(cutoff, [=] AMREX_GPU_DEVICE (int i, int /*j*/, ParticleReal /*r2*/)
+        {
+            Gpu::Atomic::AddNoRet(&pfull[i], 1);
+        });
+        cell_list.forEachPair(cutoff, [=] AMREX_GPU_DEVICE (int i, int /*j*/, ParticleReal /*r2*/)
+        {
+            Gpu::Atomic::AddNoRet(&phalf[i], 1);
+        }, true);
+
+        amrex::Gpu::HostVector<int> h_full(np);
+        amrex::Gpu::HostVector<int> h_half(np);
+        Gpu::copy(Gpu::deviceToHost, full_count.begin(), full_count.end(), h_full.begin());
+        Gpu::copy(Gpu::deviceToHost, half_count.begin(), half_count.end(), h_half.begin());
+
+        amrex::Gpu::HostVector<ParticleType> h_pstruct(np_total);
+        Gpu::copy(Gpu::deviceToHost, aos().dataPtr(), aos().dataPtr() + np_total, h_pstruct.begin());
+
+        for (int i = 0; i < np; i++)
+        {
+            ParticleType& p1 = h_pstruct[i];
+            int count = 0;
+            int owned_count = 0;
+            for (int j = 0; j < np_total; j++)
+            {
+                if ( i == j ) { continue; }
+
+                ParticleType& p2 = h_pstruct[j];
+                AMREX_D_TERM(Real dx = p1.pos(0) - p2.pos(0);,
+                             Real dy = p1.pos(1) - p2.pos(1);,
+                             Real dz = p1.pos(2) - p2.pos(2);)
+
+                Real r2 = AMREX_D_TERM(dx*dx, + dy*dy, + dz*dz);
+
+                if (r2 <= cutoff*cutoff) {
+                    ++count;
+                    if (p1.m_idcpu < p2.m_idcpu) { ++owned_count; }
+                }
+            }
+            AMREX_ALWAYS_ASSERT(h_full[i] == count);
+            AMREX_ALWAYS_ASSERT(h_half[i] == owned_count);
+        }
+    }
+
+    amrex::PrintToFile("neighbor_test") << "All the cell list pair counts match!" << '\n';
+}
+
 void MDParticleContainer::reset_test_id()
 {
     BL_PROFILE("MDParticleContainer::reset_test_id");
@@ -25,6 +25,10 @@ void testNeighborParticles();
 
 void testNeighborList();
 
+void testVerletNeighborList();
+
+void testHalfNeighborList();
+
 int main (int argc, char* argv[])
 {
     amrex::Initialize(argc,argv);
@@ -35,6 +39,14 @@ int main (int argc, char* argv[])
     amrex::PrintToFile("neighbor_test") << "Running neighbor list test \n";
     testNeighborList();
 
+    amrex::PrintToFile("neighbor_test") << "Running Verlet neighbor list test \n";
+    testVerletNeighborList();
+
+#ifndef AMREX_USE_GPU
+    amrex::PrintToFile("neighbor_test") << "Running half neighbor list test \n";
+    testHalfNeighborList();
+#endif
+
     amrex::Finalize();
 }
 
@@ -199,6 +211,7 @@ void testNeighborList ()
 
     if (params.check_answer) {
         pc.checkNeighborList();
+        pc.checkNeighborCellList();
     }
 
 #ifdef AMREX_USE_GPU
@@ -220,3 +233,113 @@ void testNeighborList ()
         pc.WritePlotFile("NeighborParticles_plt00001", "neighbors");
     }
 }
+
+void testVerletNeighborList ()
+{
+    BL_PROFILE("testVerletNeighborList");
+    TestParams params;
+    get_test_params(params, "nbor_list");
+
+    RealBox real_box;
+    for (int n = 0; n < BL_SPACEDIM; n++)
+    {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, params.size[n]);
+    }
+
+    IntVect domain_lo(AMREX_D_DECL(0, 0, 0));
+    IntVect domain_hi(AMREX_D_DECL(params.size[0]-1,params.size[1]-1,params.size[2]-1));
+    const Box domain(domain_lo, domain_hi);
+
+    int coord = 0;
+    int is_per[] = {AMREX_D_DECL(params.is_periodic,
+                                 params.is_periodic,
+                                 params.is_periodic)};
+    Geometry geom(domain, &real_box, coord, is_per);
+
+    BoxArray ba(domain);
+    ba.maxSize(params.max_grid_size);
+    DistributionMapping dm(ba);
+
+    // the neighbor cells must cover the cutoff plus the skin
+    const int ncells = 2;
+    MDParticleContainer pc(geom, dm, ba, ncells);
+
+    IntVect nppc(params.num_ppc);
+    pc.InitParticles(nppc, 1.0, 0.0);
+
+    pc.setVerletSkin(Params::verlet_skin);
+
+    const int nsteps = 10;
+    int nbuilds = 0;
+    for (int step = 0; step < nsteps; ++step)
+    {
+        if (step > 0) { pc.jiggleParticles(static_cast<amrex::ParticleReal>(0.05)); }
+
+        if (pc.updateNeighborList(VerletCheckPair())) { ++nbuilds; }
+
+        if (params.check_answer) {
+            pc.checkVerletNeighborList();
+        }
+    }
+
+    amrex::PrintToFile("neighbor_test") << "Built the Verlet neighbor list " << nbuilds
+                                        << " times in " << nsteps << " steps \n";
+    AMREX_ALWAYS_ASSERT(nbuilds > 1 && nbuilds < nsteps);
+}
+
+void testHalfNeighborList ()
+{
+    BL_PROFILE("testHalfNeighborList");
+    TestParams params;
+    get_test_params(params, "nbor_list");
+
+    RealBox real_box;
+    for (int n = 0; n < BL_SPACEDIM; n++)
+    {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, params.size[n]);
+    }
+
+    IntVect domain_lo(AMREX_D_DECL(0, 0, 0));
+    IntVect domain_hi(AMREX_D_DECL(params.size[0]-1,params.size[1]-1,params.size[2]-1));
+    const Box domain(domain_lo, domain_hi);
+
+    int coord = 0;
+    int is_per[] = {AMREX_D_DECL(params.is_periodic,
+                                 params.is_periodic,
+                                 params.is_periodic)};
+    Geometry geom(domain, &real_box, coord, is_per);
+
+    BoxArray ba(domain);
+    ba.maxSize(params.max_grid_size);
+    DistributionMapping dm(ba);
+
+    const int ncells = 1;
+    MDParticleContainer pc(geom, dm, ba, ncells);
+    pc.setEnableInverse(true);
+    pc.setHalfNeighborList(true);
+
+    IntVect nppc(params.num_ppc);
+    pc.InitParticles(nppc, 1.0, 0.0);
+
+    pc.fillNeighbors();
+    pc.buildNeighborList(CheckPair());
+
+    pc.countNeighborsWithHalfList();
+    pc.sumNeighbors(PIdx::ax, 1, 0, 0);
+
+    if (params.check_answer) {
+        pc.checkHalfNeighborList();
+    }
+
+    // a half cell list traversal visits the pairs across tiles only once too
+    pc.countNeighborsWithHalfCellList();
+    pc.sumNeighbors(PIdx::ax, 1, 0, 0);
+
+    if (params.check_answer) {
+        pc.checkHalfNeighborList();
+    }
+
+    pc.setEnableInverse(false);
+}
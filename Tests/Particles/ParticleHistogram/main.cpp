@@ -0,0 +1,186 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Particles.H>
+
+#include <cmath>
+
+using namespace amrex;
+
+static constexpr int NSR = 2;
+static constexpr int NSI = 0;
+static constexpr int NAR = 1;
+static constexpr int NAI = 0;
+
+class TestParticleContainer
+    : public amrex::ParticleContainer<NSR, NSI, NAR, NAI>
+{
+
+public:
+
+    TestParticleContainer (const amrex::Geometry            & a_geom,
+                           const amrex::DistributionMapping & a_dmap,
+                           const amrex::BoxArray            & a_ba)
+        : amrex::ParticleContainer<NSR, NSI, NAR, NAI>(a_geom, a_dmap, a_ba)
+    {}
+
+    //! num_ppc particles per cell, evenly spaced in x, with weight 1
+    void InitParticles (int num_ppc)
+    {
+        BL_PROFILE("InitParticles");
+        const int lev = 0;
+        const Real* dx = Geom(lev).CellSize();
+        const Real* plo = Geom(lev).ProbLo();
+
+        for(MFIter mfi = MakeMFIter(lev); mfi.isValid(); ++mfi)
+        {
+            const Box& tile_box  = mfi.tilebox();
+
+            Gpu::HostVector<ParticleType> host_particles;
+            Gpu::HostVector<ParticleReal> host_real;
+            for (IntVect iv = tile_box.smallEnd(); iv <= tile_box.bigEnd(); tile_box.next(iv))
+            {
+                for (int i_part=0; i_part<num_ppc;i_part++) {
+                    ParticleType p;
+                    p.id()  = ParticleType::NextID();
+                    p.cpu() = ParallelDescriptor::MyProc();
+                    p.pos(0) = static_cast<ParticleReal>
+                        (plo[0] + (iv[0] + (0.5+i_part)/num_ppc)*dx[0]);
+                    for (int idim = 1; idim < AMREX_SPACEDIM; ++idim) {
+                        p.pos(idim) = static_cast<ParticleReal>(plo[idim] + (iv[idim] + 0.5)*dx[idim]);
+                    }
+                    for (int i = 0; i < NSR; ++i) { p.rdata(i) = ParticleReal(i); }
+
+                    host_particles.push_back(p);
+                    host_real.push_back(ParticleReal(1.0));
+                }
+            }
+
+            auto& particle_tile = DefineAndReturnParticleTile(lev, mfi);
+            auto old_size = particle_tile.GetArrayOfStructs().size();
+            particle_tile.resize(old_size + host_particles.size());
+
+            Gpu::copyAsync(Gpu::hostToDevice, host_particles.begin(), host_particles.end(),
+                           particle_tile.GetArrayOfStructs().begin() + old_size);
+            Gpu::copyAsync(Gpu::hostToDevice, host_real.begin(), host_real.end(),
+                           particle_tile.GetStructOfArrays().GetRealData(0).begin() + old_size);
+
+            Gpu::streamSynchronize();
+        }
+    }
+};
+
+struct TestParams
+{
+    IntVect size;
+    int max_grid_size;
+    int num_ppc;
+};
+
+void testHistogram();
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    amrex::Print() << "Running particle histogram test \n";
+    testHistogram();
+
+    amrex::Finalize();
+}
+
+void get_test_params(TestParams& params, const std::string& prefix)
+{
+    ParmParse pp(prefix);
+    pp.get("size", params.size);
+    pp.get("max_grid_size", params.max_grid_size);
+    pp.get("num_ppc", params.num_ppc);
+}
+
+void testHistogram ()
+{
+    BL_PROFILE("testHistogram");
+    TestParams params;
+    get_test_params(params, "histogram");
+
+    RealBox real_box;
+    for (int n = 0; n < BL_SPACEDIM; n++)
+    {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, params.size[n]);
+    }
+
+    IntVect domain_lo(AMREX_D_DECL(0, 0, 0));
+    IntVect domain_hi(AMREX_D_DECL(params.size[0]-1,params.size[1]-1,params.size[2]-1));
+    const Box domain(domain_lo, domain_hi);
+
+    int coord = 0;
+    int is_per[] = {AMREX_D_DECL(1,1,1)};
+    Geometry geom(domain, &real_box, coord, is_per);
+
+    BoxArray ba(domain);
+    ba.maxSize(params.max_grid_size);
+    DistributionMapping dm(ba);
+
+    TestParticleContainer pc(geom, dm, ba);
+    pc.InitParticles(params.num_ppc);
+
+    using SPType  = typename TestParticleContainer::SuperParticleType;
+    using PType   = typename TestParticleContainer::ParticleType;
+    using PTDType = typename TestParticleContainer::ParticleTileType::ConstParticleTileDataType;
+
+    const Real np_per_slab = Real(pc.TotalNumberOfParticles()) / params.size[0];
+    const ParticleHistogramBins bins{0.0_rt, Real(params.size[0]), 16};
+    const Real slabs_per_bin = Real(params.size[0]) / bins.nbins;
+
+    // Weighted histogram of x, with the weights in the SoA
+    auto h = amrex::ParticleHistogram(pc, bins,
+        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real { return p.pos(0); },
+        [=] AMREX_GPU_HOST_DEVICE (const SPType& p) -> Real { return p.rdata(NSR); });
+    AMREX_ALWAYS_ASSERT(static_cast<int>(h.size()) == bins.nbins);
+    for (int b = 0; b < bins.nbins; ++b) {
+        AMREX_ALWAYS_ASSERT(h[b] == np_per_slab*slabs_per_bin);
+    }
+
+    // Count, mean and variance of x in each bin
+    auto m = amrex::ParticleBinnedSum<3>(pc, bins.nbins,
+        [=] AMREX_GPU_HOST_DEVICE (const PTDType& ptd, const int i) -> ParticleBinnedValue<3>
+        {
+            const Real x = ptd.m_aos[i].pos(0);
+            return {bins.index(x), {1.0_rt, x, x*x}};
+        });
+    const Real dx_part = 1.0_rt / params.num_ppc;
+    const Real nx_per_bin = slabs_per_bin * params.num_ppc;
+    for (int b = 0; b < bins.nbins; ++b) {
+        const Real n = m[3*b];
+        const Real mean = m[3*b+1] / n;
+        const Real var = m[3*b+2] / n - mean*mean;
+        AMREX_ALWAYS_ASSERT(n == h[b]);
+        AMREX_ALWAYS_ASSERT(std::abs(mean - bins.center(b)) < 1.e-6_rt);
+        AMREX_ALWAYS_ASSERT(std::abs(var - (nx_per_bin*nx_per_bin-1.0_rt)*dx_part*dx_part/12.0_rt)
+                            < 1.e-3_rt);
+    }
+
+    // Without the MPI reduction, each process only counts its own particles
+    auto hl = amrex::ParticleHistogram(pc, bins,
+        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real { return p.pos(0); },
+        [=] AMREX_GPU_HOST_DEVICE (const PType&) -> Real { return 1.0_rt; },
+        true);
+    Real nlocal = 0.0_rt;
+    for (auto v : hl) { nlocal += v; }
+    AMREX_ALWAYS_ASSERT(nlocal == Real(pc.TotalNumberOfParticles(true, true)));
+    ParallelAllReduce::Sum(hl.data(), bins.nbins, ParallelDescriptor::Communicator());
+    for (int b = 0; b < bins.nbins; ++b) {
+        AMREX_ALWAYS_ASSERT(hl[b] == h[b]);
+    }
+
+    // Particles mapped to no bin are not counted
+    auto empty = amrex::ParticleBinnedSum<1>(pc, 4,
+        [=] AMREX_GPU_HOST_DEVICE (const SPType&) -> ParticleBinnedValue<1>
+        {
+            return {-1, {1.0_rt}};
+        });
+    for (auto v : empty) { AMREX_ALWAYS_ASSERT(v == 0.0_rt); }
+
+    amrex::Print() << "pass \n";
+}
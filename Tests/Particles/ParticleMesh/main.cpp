@@ -69,9 +69,8 @@ void testParticleMesh (TestParams& parms)
   int nc = 1 + AMREX_SPACEDIM;
   const auto plo = geom.ProbLoArray();
   const auto dxi = geom.InvCellSizeArray();
-  amrex::ParticleToMesh(myPC, partMF, 0,
-                        [=] AMREX_GPU_DEVICE (const MyParticleContainer::ParticleTileType::ConstParticleTileDataType& ptd, int i,
-                                              amrex::Array4<amrex::Real> const& rho)
+  auto deposit = [=] AMREX_GPU_DEVICE (const MyParticleContainer::ParticleTileType::ConstParticleTileDataType& ptd, int i,
+                                       amrex::Array4<amrex::Real> const& rho)
       {
           auto p = ptd.m_aos[i];
           ParticleInterpolator::Linear interp(p, plo, dxi);
@@ -87,7 +86,38 @@ void testParticleMesh (TestParams& parms)
                       {
                           return part.rdata(0) * p.rdata(comp);  // mass weight these comps
                       });
+      };
+  amrex::ParticleToMesh(myPC, partMF, 0, deposit);
+
+  // The cell-sorted deposition must agree with the above up to roundoff.
+  // With tiling, it deposits the tiles of each color in turn.
+  if (MyParticleContainer::do_tiling && ParallelDescriptor::IOProcessor()) {
+      std::cout << "Tile size                    : " << MyParticleContainer::tile_size << '\n' << '\n';
+  }
+  myPC.SortParticlesForDeposition(IntVect(AMREX_D_DECL(0,0,0)));
+  MultiFab partMF_sorted(ba, dmap, 1 + AMREX_SPACEDIM, 1);
+  amrex::ParticleToMeshSorted(myPC, partMF_sorted, 0, deposit);
+  for (int n = 0; n < 1 + AMREX_SPACEDIM; ++n) {
+      Real scale = partMF.norminf(n);
+      MultiFab::Subtract(partMF_sorted, partMF, n, n, 1, 0);
+      AMREX_ALWAYS_ASSERT(partMF_sorted.norminf(n) <= 1.e-12 * scale);
+  }
+
+  // Quadratic deposition conserves the total mass
+  MultiFab massMF(ba, dmap, 1, 2);
+  amrex::ParticleToMeshSorted(myPC, massMF, 0,
+      [=] AMREX_GPU_DEVICE (const MyParticleContainer::ParticleType& p,
+                            amrex::Array4<amrex::Real> const& rho)
+      {
+          ParticleInterpolator::Quadratic interp(p, plo, dxi);
+
+          interp.ParticleToMesh(p, rho, 0, 0, 1,
+                      [=] AMREX_GPU_DEVICE (const MyParticleContainer::ParticleType& part, int comp)
+                      {
+                          return part.rdata(comp);
+                      });
       });
+  AMREX_ALWAYS_ASSERT(std::abs(massMF.sum(0) - mass*num_particles) <= 1.e-10 * mass*num_particles);
 
   MultiFab acceleration(ba, dmap, AMREX_SPACEDIM, 1);
   acceleration.setVal(5.0);
@@ -15,6 +15,8 @@ int num_runtime_int = 0;
 
 bool remove_negative = true;
 
+bool local_fallback = false;
+
 void get_position_unit_cell(Real* r, const IntVect& nppc, int i_part)
 {
     int nx = nppc[0];
@@ -62,6 +64,11 @@ public:
 
     void RedistributeLocal (bool remove_neg=true)
     {
+        if (local_fallback) {
+            amrex::ParticleContainer<NSR, NSI, NAR, NAI>::RedistributeLocal(1, remove_neg);
+            return;
+        }
+
         const int lev_min = 0;
         const int lev_max = finestLevel();
         const int nGrow = 0;
@@ -237,6 +244,40 @@ public:
         }
     }
 
+    // Move a tenth of the particles by half the domain in the last direction
+    void jumpParticles (int step)
+    {
+        BL_PROFILE("TestParticleContainer::jumpParticles");
+
+        constexpr int idir = AMREX_SPACEDIM-1;
+        const auto lo = static_cast<ParticleReal>(Geom(0).ProbLo(idir));
+        const auto len = static_cast<ParticleReal>(Geom(0).ProbLength(idir));
+        const Long which = step % 10;
+
+        for (int lev = 0; lev <= finestLevel(); ++lev)
+        {
+            auto& plev  = GetParticles(lev);
+            for(MFIter mfi = MakeMFIter(lev); mfi.isValid(); ++mfi)
+            {
+                int gid = mfi.index();
+                int tid = mfi.LocalTileIndex();
+                auto& ptile = plev[std::make_pair(gid, tid)];
+                auto& aos   = ptile.GetArrayOfStructs();
+                ParticleType* pstruct = aos.data();
+                const size_t np = aos.numParticles();
+                amrex::ParallelFor( np, [=] AMREX_GPU_DEVICE (int i) noexcept
+                {
+                    ParticleType& p = pstruct[i];
+                    if (p.id() % 10 == which) {
+                        ParticleReal x = p.pos(idir) + ParticleReal(0.5)*len;
+                        if (x >= lo + len) { x -= len; }
+                        p.pos(idir) = x;
+                    }
+                });
+            }
+        }
+    }
+
     void negateEven ()
     {
         BL_PROFILE("TestParticleContainer::invalidateEven");
@@ -259,6 +300,7 @@ public:
                         p.id() = -p.id();
                     }
                 });
+                MarkTileChanged(lev, gid, tid);
             }
         }
     }
@@ -313,6 +355,32 @@ public:
             }
         }
     }
+
+    void checkSorted () const
+    {
+        BL_PROFILE("TestParticleContainer::checkSorted");
+
+        for (int lev = 0; lev <= finestLevel(); ++lev)
+        {
+            const auto& geom = Geom(lev);
+            const auto& plev = GetParticles(lev);
+            for(MFIter mfi = MakeMFIter(lev); mfi.isValid(); ++mfi)
+            {
+                const auto& ptile = plev.at(std::make_pair(mfi.index(), mfi.LocalTileIndex()));
+                const auto* pstruct = ptile.GetArrayOfStructs().data();
+                const int np = ptile.numParticles();
+
+                GetParticleBin get_bin{geom.ProbLoArray(), geom.InvCellSizeArray(), geom.Domain(),
+                                       IntVect(1), mfi.validbox()};
+                int nbad = amrex::Reduce::Sum<int>(amrex::max(np-1, 0),
+                    [=] AMREX_GPU_DEVICE (int i) -> int
+                    {
+                        return get_bin(pstruct[i]) > get_bin(pstruct[i+1]);
+                    });
+                AMREX_ALWAYS_ASSERT(nbad == 0);
+            }
+        }
+    }
 };
 
 struct TestParams
@@ -328,6 +396,7 @@ struct TestParams
     int do_regrid;
     int sort;
     int test_level_lost = 0;
+    int jump_every = 0;
 };
 
 void testRedistribute();
@@ -358,6 +427,8 @@ void get_test_params(TestParams& params, const std::string& prefix)
     pp.query("num_runtime_real", num_runtime_real);
     pp.query("num_runtime_int", num_runtime_int);
     pp.query("remove_negative", remove_negative);
+    pp.query("local_fallback", local_fallback);
+    pp.query("jump_every", params.jump_every);
 
     params.sort = 0;
     pp.query("sort", params.sort);
@@ -369,6 +440,9 @@ void testRedistribute ()
     TestParams params;
     get_test_params(params, "redistribute");
 
+    // Particles that jump farther than the local range need the fallback
+    AMREX_ALWAYS_ASSERT(params.jump_every == 0 || (local_fallback && params.is_periodic));
+
     int is_per[] = {AMREX_D_DECL(params.is_periodic,
                                  params.is_periodic,
                                  params.is_periodic)};
@@ -423,9 +497,16 @@ void testRedistribute ()
 
     if (params.sort) { pc.SortParticlesByCell(); }
 
+    ParticleIdIndex<TestParticleContainer> id_index(pc);
+    id_index.build();
+
     for (int i = 0; i < params.nsteps; ++i)
     {
         pc.moveParticles(params.move_dir, params.do_random);
+        if (params.jump_every > 0 && i % params.jump_every == 0) {
+            pc.jumpParticles(i);
+            AMREX_ALWAYS_ASSERT(pc.hasParticlesOutOfLocalRange(1));
+        }
         if (!remove_negative) {
             auto old = pc.TotalNumberOfParticles();
             pc.negateEven();
@@ -434,8 +515,94 @@ void testRedistribute ()
             pc.negateEven();
         }
         pc.RedistributeLocal();
-        if (params.sort) { pc.SortParticlesByCell(); }
+        if (params.sort) {
+            pc.SortParticlesByCell();
+            pc.checkSorted();
+        }
         pc.checkAnswer();
+
+        // the index follows the particles without a rebuild
+        id_index.update();
+        AMREX_ALWAYS_ASSERT(id_index.size() == pc.TotalNumberOfParticles(true, true));
+    }
+
+    {
+        // a Redistribute that moves nothing does not touch the index
+        const Long nupdates = id_index.numTileUpdates();
+        pc.RedistributeLocal();
+        id_index.update();
+        AMREX_ALWAYS_ASSERT(id_index.numTileUpdates() == nupdates);
+    }
+
+    if (params.sort) {
+        const auto& stats = pc.SortStats();
+        Long nsorts[2] = {stats.num_full_sorts, stats.num_incremental_sorts};
+        ParallelDescriptor::ReduceLongSum(nsorts, 2);
+        amrex::Print() << "Tile sorts: " << nsorts[0] << " full, "
+                       << nsorts[1] << " incremental\n";
+    }
+
+    {
+        // the particles have moved since the index was built
+        const int NProcs = ParallelDescriptor::NProcs();
+        Vector<std::pair<Long,int>> ids;
+        for (int proc = 0; proc < NProcs; ++proc) {
+            for (Long id : {1, 7, 50}) { ids.emplace_back(id, proc); }
+        }
+        ids.emplace_back(LongParticleIds::LastParticleID, 0);
+
+        using PType = TestParticleContainer::ParticleType;
+        Vector<int> owner;
+        auto v = id_index.query<2>(ids,
+            [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> GpuArray<Real,2>
+            {
+                return {Real(p.rdata(0)), Real(p.idata(0))};
+            }, &owner);
+
+        const int nq = static_cast<int>(ids.size());
+        for (int k = 0; k < nq-1; ++k) {
+            AMREX_ALWAYS_ASSERT(owner[k] >= 0 && owner[k] < NProcs);
+            AMREX_ALWAYS_ASSERT(v[2*k] == Real(ids[k].first) && v[2*k+1] == Real(ids[k].first));
+            if (owner[k] == ParallelDescriptor::MyProc()) {
+                const auto loc = id_index.find(ids[k].first, ids[k].second);
+                AMREX_ALWAYS_ASSERT(loc.isValid());
+                const auto& ptile = pc.GetParticles(loc.lev).at(std::make_pair(loc.grid, loc.tile));
+                AMREX_ALWAYS_ASSERT(loc.index < ptile.numRealParticles());
+            }
+        }
+        AMREX_ALWAYS_ASSERT(owner[nq-1] == -1 && v[2*(nq-1)] == 0.0_rt);
+
+        // every local particle is where the index says it is
+        for (int lev = 0; lev <= pc.finestLevel(); ++lev) {
+            for (const auto& kv : pc.GetParticles(lev)) {
+                const int np = kv.second.numRealParticles();
+                Gpu::DeviceVector<Long> d_ids(np);
+                Gpu::DeviceVector<int> d_cpus(np);
+                Long* pids = d_ids.dataPtr();
+                int* pcpus = d_cpus.dataPtr();
+                const auto ptd = kv.second.getConstParticleTileData();
+                amrex::ParallelFor(np, [=] AMREX_GPU_DEVICE (int i) noexcept
+                {
+                    pids[i] = ptd.m_aos[i].id();
+                    pcpus[i] = ptd.m_aos[i].cpu();
+                });
+                Vector<Long> h_ids(np);
+                Vector<int> h_cpus(np);
+                Gpu::copyAsync(Gpu::deviceToHost, d_ids.begin(), d_ids.end(), h_ids.begin());
+                Gpu::copyAsync(Gpu::deviceToHost, d_cpus.begin(), d_cpus.end(), h_cpus.begin());
+                Gpu::streamSynchronize();
+                for (int i = 0; i < np; ++i) {
+                    const auto loc = id_index.find(h_ids[i], h_cpus[i]);
+                    AMREX_ALWAYS_ASSERT(loc.lev == lev && loc.grid == kv.first.first &&
+                                        loc.tile == kv.first.second && loc.index == i);
+                }
+            }
+        }
+
+        Long nupdates = id_index.numTileUpdates();
+        ParallelDescriptor::ReduceLongSum(nupdates);
+        amrex::Print() << "Particle id index: " << nupdates << " tile updates\n";
+        AMREX_ALWAYS_ASSERT(id_index.numBuilds() == 1);
     }
 
     if (params.do_regrid)
@@ -481,6 +648,28 @@ void testRedistribute ()
             pc.checkAnswer();
         }
 
+        {
+            MultiFab mf(ba[0], pc.ParticleDistributionMap(0), 1, 1);
+            for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+                mf[mfi].setVal<RunOn::Device>(Real(mfi.index()+1));
+            }
+            const Real sum_old = mf.sum(0);
+            const auto np_before_rebalance = pc.TotalNumberOfParticles();
+
+            // a negative min_improvement moves the data even if the mapping does not improve
+            ParticleMeshCostModel model;
+            model.particle_cost = 4.0_rt;
+            bool moved = RebalanceParticlesAndMesh(pc, 0, {&mf}, model, -1.0_rt, 1);
+            AMREX_ALWAYS_ASSERT(moved);
+            AMREX_ALWAYS_ASSERT(mf.DistributionMap() == pc.ParticleDistributionMap(0));
+            AMREX_ALWAYS_ASSERT(np_before_rebalance == pc.TotalNumberOfParticles());
+            AMREX_ALWAYS_ASSERT(amrex::almostEqual(sum_old, mf.sum(0)));
+            for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+                AMREX_ALWAYS_ASSERT(mf[mfi].min<RunOn::Device>(0) == Real(mfi.index()+1));
+            }
+            pc.checkAnswer();
+        }
+
         if (params.test_level_lost) {
             AMREX_ALWAYS_ASSERT(params.nlevs > 2);
             auto np_before_level_lost = pc.TotalNumberOfParticles();
@@ -500,6 +689,17 @@ void testRedistribute ()
         AMREX_ALWAYS_ASSERT(np_old == pc.TotalNumberOfParticles());
     }
 
+    {
+        pc.negateEven();
+        auto np_odd = pc.TotalNumberOfParticles();
+        pc.Compact();
+        AMREX_ALWAYS_ASSERT(np_odd == pc.TotalNumberOfParticles(false));
+        for (const auto& usage : pc.MemoryUsage()) {
+            AMREX_ALWAYS_ASSERT(usage.invalid_bytes == 0 && usage.wastedBytes() == 0);
+        }
+        pc.checkAnswer();
+    }
+
     // the way this test is set up, if we make it here we pass
     amrex::Print() << "pass \n";
 }
@@ -0,0 +1,220 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Particles.H>
+
+using namespace amrex;
+
+// weight and velocity in the struct, and one array component
+static constexpr int NSR = 1 + AMREX_SPACEDIM;
+using AoSPC = ParticleContainer<NSR, 0, 1, 0>;
+
+// position, weight, velocity and one more component
+using SoAPC = ParticleContainerPureSoA<2 + 2*AMREX_SPACEDIM, 0>;
+
+//! Component of the weight in the SuperParticleType. The velocity and one
+//! more component follow it.
+template <class PC>
+constexpr int weightComp () { return PC::ParticleType::is_soa_particle ? AMREX_SPACEDIM : 0; }
+
+struct TestParams
+{
+    IntVect size;
+    int max_grid_size;
+    int max_ppc;
+    int min_ppc;
+};
+
+template <class PC>
+void testResample (const std::string& name);
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    amrex::Print() << "Running particle resampling test \n";
+    testResample<AoSPC>("AoS");
+    testResample<SoAPC>("pure SoA");
+    amrex::Print() << "pass \n";
+
+    amrex::Finalize();
+}
+
+void get_test_params (TestParams& params, const std::string& prefix)
+{
+    ParmParse pp(prefix);
+    pp.get("size", params.size);
+    pp.get("max_grid_size", params.max_grid_size);
+    pp.get("max_ppc", params.max_ppc);
+    pp.get("min_ppc", params.min_ppc);
+}
+
+//! Number of particles put in cell iv: many in the lower half in x, a few elsewhere
+int initialCount (const IntVect& iv, const IntVect& size)
+{
+    return (iv[0] < size[0]/2) ? 20 : 1 + (iv[AMREX_SPACEDIM-1] % 3);
+}
+
+template <class PC>
+void initParticles (PC& pc, const IntVect& size)
+{
+    using SPType = typename PC::SuperParticleType;
+    constexpr int wc = weightComp<PC>();
+
+    const int lev = 0;
+    const auto plo = pc.Geom(lev).ProbLoArray();
+    const auto dx = pc.Geom(lev).CellSizeArray();
+
+    for (MFIter mfi = pc.MakeMFIter(lev); mfi.isValid(); ++mfi)
+    {
+        const Box& tile_box = mfi.tilebox();
+        typename PC::ParticleTileType host_tile;
+        host_tile.define(0, 0);
+        for (IntVect iv = tile_box.smallEnd(); iv <= tile_box.bigEnd(); tile_box.next(iv))
+        {
+            for (int n = 0; n < initialCount(iv, size); ++n)
+            {
+                SPType p;
+                p.id() = PC::ParticleType::NextID();
+                p.cpu() = ParallelDescriptor::MyProc();
+                for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                    p.pos(d) = static_cast<ParticleReal>(plo[d] + (iv[d] + amrex::Random())*dx[d]);
+                    if constexpr (PC::ParticleType::is_soa_particle) { p.rdata(d) = p.pos(d); }
+                    p.rdata(wc+1+d) = static_cast<ParticleReal>(amrex::RandomNormal(d, 1.0));
+                }
+                p.rdata(wc) = static_cast<ParticleReal>(0.5 + amrex::Random());
+                p.rdata(wc+1+AMREX_SPACEDIM) = static_cast<ParticleReal>(amrex::Random());
+                host_tile.push_back(p);
+            }
+        }
+
+        auto& ptile = pc.DefineAndReturnParticleTile(lev, mfi);
+        ptile.resize(host_tile.numParticles());
+        amrex::copyParticles(ptile, host_tile, 0, 0, host_tile.numParticles());
+    }
+    pc.Redistribute();
+}
+
+//! Total weight, momentum, energy, weighted center and weighted array component
+template <class PC>
+Vector<Real> moments (const PC& pc)
+{
+    using SPType = typename PC::SuperParticleType;
+    constexpr int wc = weightComp<PC>();
+    constexpr int NM = 3 + 2*AMREX_SPACEDIM;
+    auto m = ParticleBinnedSum<NM>(pc, 1,
+        [=] AMREX_GPU_HOST_DEVICE (const SPType& p) -> ParticleBinnedValue<NM>
+        {
+            ParticleBinnedValue<NM> r;
+            r.bin = 0;
+            const Real w = p.rdata(wc);
+            r.value[0] = w;
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                r.value[1+d] = w*p.rdata(wc+1+d);
+                r.value[1+AMREX_SPACEDIM] += 0.5_rt*w*p.rdata(wc+1+d)*p.rdata(wc+1+d);
+                r.value[2+AMREX_SPACEDIM+d] = w*p.pos(d);
+            }
+            r.value[2+2*AMREX_SPACEDIM] = w*p.rdata(wc+1+AMREX_SPACEDIM);
+            return r;
+        });
+    return m;
+}
+
+template <class PC>
+void testResample (const std::string& name)
+{
+    using SPType = typename PC::SuperParticleType;
+    amrex::Print() << name << " particles\n";
+
+    TestParams params;
+    get_test_params(params, "resample");
+
+    RealBox real_box;
+    for (int n = 0; n < AMREX_SPACEDIM; n++) {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, params.size[n]);
+    }
+    const Box domain(IntVect(AMREX_D_DECL(0, 0, 0)), params.size - 1);
+    Array<int,AMREX_SPACEDIM> is_per{AMREX_D_DECL(1, 1, 1)};
+    Geometry geom(domain, real_box, CoordSys::cartesian, is_per);
+
+    BoxArray ba(domain);
+    ba.maxSize(params.max_grid_size);
+    DistributionMapping dm(ba);
+
+    PC pc(geom, dm, ba);
+    initParticles(pc, params.size);
+
+    ParticleIdIndex<PC> id_index(pc);
+    id_index.build();
+
+    const auto m_old = moments(pc);
+
+    ParticleResampleParams rp;
+    rp.weight_comp = weightComp<PC>();
+    rp.vel_comp = weightComp<PC>() + 1;
+    rp.max_ppc = params.max_ppc;
+    rp.min_ppc = params.min_ppc;
+    ResampleParticles(pc, rp);
+
+    AMREX_ALWAYS_ASSERT(pc.OK());
+
+    const auto m_new = moments(pc);
+    for (int n = 0; n < static_cast<int>(m_old.size()); ++n) {
+        amrex::Print() << "moment " << n << ": " << m_old[n] << " -> " << m_new[n] << "\n";
+        AMREX_ALWAYS_ASSERT(std::abs(m_new[n] - m_old[n]) <= 1.e-10_rt * (1.0_rt + std::abs(m_old[n])));
+    }
+
+    // the particles stay in their cells, and each cell ends up with the expected count
+    const auto plo = geom.ProbLoArray();
+    const auto dxi = geom.InvCellSizeArray();
+    const int ncells = static_cast<int>(domain.numPts());
+    auto count = ParticleBinnedSum<1>(pc, ncells,
+        [=] AMREX_GPU_HOST_DEVICE (const SPType& p) -> ParticleBinnedValue<1>
+        {
+            const IntVect iv = getParticleCell(p, plo, dxi, domain);
+            return {static_cast<int>(domain.index(iv)), {1.0_rt}};
+        });
+
+    Long np_expected = 0;
+    for (int c = 0; c < ncells; ++c) {
+        const IntVect iv = domain.atOffset(c);
+        const int n = initialCount(iv, params.size);
+        int expected = n;
+        if (n > params.max_ppc) {
+            expected = 2*(params.max_ppc/2);
+        } else if (n < params.min_ppc) {
+            expected = n + std::min(n, params.min_ppc - n);
+        }
+        AMREX_ALWAYS_ASSERT(count[c] == Real(expected));
+        np_expected += expected;
+    }
+    AMREX_ALWAYS_ASSERT(pc.TotalNumberOfParticles() == np_expected);
+
+    // the new particles have unique ids, and the index finds every particle without a rebuild
+    id_index.update();
+    AMREX_ALWAYS_ASSERT(id_index.size() == pc.TotalNumberOfParticles(true, true));
+    for (const auto& kv : pc.GetParticles(0)) {
+        const int np = kv.second.numRealParticles();
+        Gpu::DeviceVector<Long> d_ids(np);
+        Gpu::DeviceVector<int> d_cpus(np);
+        Long* pids = d_ids.dataPtr();
+        int* pcpus = d_cpus.dataPtr();
+        const auto ptd = kv.second.getConstParticleTileData();
+        amrex::ParallelFor(np, [=] AMREX_GPU_DEVICE (int i) noexcept
+        {
+            pids[i] = ptd.id(i);
+            pcpus[i] = ptd.cpu(i);
+        });
+        Vector<Long> h_ids(np);
+        Vector<int> h_cpus(np);
+        Gpu::copyAsync(Gpu::deviceToHost, d_ids.begin(), d_ids.end(), h_ids.begin());
+        Gpu::copyAsync(Gpu::deviceToHost, d_cpus.begin(), d_cpus.end(), h_cpus.begin());
+        Gpu::streamSynchronize();
+        for (int i = 0; i < np; ++i) {
+            const auto loc = id_index.find(h_ids[i], h_cpus[i]);
+            AMREX_ALWAYS_ASSERT(loc.lev == 0 && loc.grid == kv.first.first &&
+                                loc.tile == kv.first.second && loc.index == i);
+        }
+    }
+    AMREX_ALWAYS_ASSERT(id_index.numBuilds() == 1);
+}